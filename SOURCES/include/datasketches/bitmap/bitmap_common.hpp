@@ -0,0 +1,95 @@
+#ifndef VERTICA_UDFS_BITMAP_COMMON_HPP
+#define VERTICA_UDFS_BITMAP_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bitmap_const.hpp"
+#include "roaring_bitmap.hpp"
+#include "../common.hpp"
+#include "../trace.hpp"
+
+using namespace Vertica;
+
+/**
+ * Size of the bitmaps built by aggregates, from the maxBytes parameter.
+ */
+size_t readBitmapMaxBytes(ServerInterface &serverInterface);
+
+void addBitmapMaxBytesParameter(SizedColumnTypes &parameterTypes);
+
+/**
+ * Serializes bitmap straight into out. Throws std::length_error if it takes more than maxBytes.
+ */
+void serializeBitmap(const roaring_bitmap &bitmap, VString &out, size_t maxBytes);
+
+/**
+ * Aggregate building a bitmap. The bitmap stays live across the blocks of a group and is only serialized at the
+ * end of each block; combine() unions intermediates.
+ */
+class BitmapAggregateFunction : public AggregateFunction {
+protected:
+    size_t maxBytes;
+    uint8_t traceLevel;
+    roaring_bitmap bitmap;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes);
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs);
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther);
+
+    virtual void terminate(ServerInterface &srvInterface,
+                           BlockWriter &resWriter,
+                           IntermediateAggs &aggs);
+};
+
+class BitmapAggregateFunctionFactory : public AggregateFunctionFactory {
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        intermediateTypeMetaData.addLongVarbinary(readBitmapMaxBytes(srvInterface));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(readBitmapMaxBytes(srvfloaterface));
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addBitmapMaxBytesParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+/**
+ * Scalar function reading serialized bitmaps through a per instance cache, as theta scalar functions do.
+ */
+class BitmapScalarFunction : public ScalarFunction {
+protected:
+    uint8_t traceLevel;
+    SketchCache<roaring_bitmap> cache;
+
+    SketchCache<roaring_bitmap>::sketch_ptr getBitmap(const VString &bytes) {
+        return cache.get(bytes.data(), bytes.length(), roaring_bitmap::deserialize);
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->cache.setCapacity(readCacheSize(srvInterface));
+    }
+
+    virtual void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        LogTrace(traceLevel, TRACE_INFO, srvInterface, "bitmap cache: %llu hits, %llu misses",
+                 (unsigned long long) cache.getHits(), (unsigned long long) cache.getMisses());
+    }
+};
+
+#endif //VERTICA_UDFS_BITMAP_COMMON_HPP
@@ -0,0 +1,10 @@
+#ifndef VERTICA_UDFS_BITMAP_CONST_H
+#define VERTICA_UDFS_BITMAP_CONST_H
+
+#define DATASKETCHES_BITMAP_MAX_BYTES_PARAMETER_NAME "maxBytes"
+// About 70000 sparse ids (14 bytes each), 500000 ids in arrays (2 bytes each) or 7 million in full bitmaps.
+#define DATASKETCHES_BITMAP_MAX_BYTES_DEFAULT 1000000
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_BITMAP_MAX_SERIALIZED_SIZE 32000000
+
+#endif //VERTICA_UDFS_BITMAP_CONST_H
@@ -0,0 +1,55 @@
+#ifndef VERTICA_UDFS_BLOOM_COMMON_HPP
+#define VERTICA_UDFS_BLOOM_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstdint>
+#include "bloom_const.hpp"
+#include "bloom_filter.hpp"
+#include "../common.hpp"
+#include "../trace.hpp"
+
+using namespace Vertica;
+
+/**
+ * Number of blocks of the filters for the numItems and fpp parameters.
+ */
+uint32_t readBloomNumBlocks(ServerInterface &serverInterface);
+
+void addBloomSizeParameters(SizedColumnTypes &parameterTypes);
+
+/**
+ * Values policies hash the value of a column of the current row, as datasketches hashes it (bytes of strings,
+ * 8 bytes of integers), and return false for NULL values.
+ */
+struct BloomVarcharValues {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addVarchar();
+    }
+
+    static bool hash(BlockReader &argReader, size_t column, uint64_t seed, HashState &hashes) {
+        const VString &value = argReader.getStringRef(column);
+        if (value.isNull()) {
+            return false;
+        }
+        hashes = bloom_filter::hash(value.data(), value.length(), seed);
+        return true;
+    }
+};
+
+struct BloomIntValues {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addInt();
+    }
+
+    static bool hash(BlockReader &argReader, size_t column, uint64_t seed, HashState &hashes) {
+        const vint value = argReader.getIntRef(column);
+        if (value == vint_null) {
+            return false;
+        }
+        const int64_t value64 = value;
+        hashes = bloom_filter::hash(&value64, sizeof(value64), seed);
+        return true;
+    }
+};
+
+#endif //VERTICA_UDFS_BLOOM_COMMON_HPP
@@ -0,0 +1,11 @@
+#ifndef VERTICA_UDFS_BLOOM_CONST_H
+#define VERTICA_UDFS_BLOOM_CONST_H
+
+#define DATASKETCHES_BLOOM_NUM_ITEMS_PARAMETER_NAME "numItems"
+#define DATASKETCHES_BLOOM_NUM_ITEMS_DEFAULT 1000000
+#define DATASKETCHES_BLOOM_FPP_PARAMETER_NAME "fpp"
+#define DATASKETCHES_BLOOM_FPP_DEFAULT 0.01
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_BLOOM_MAX_SERIALIZED_SIZE 32000000
+
+#endif //VERTICA_UDFS_BLOOM_CONST_H
@@ -0,0 +1,34 @@
+#ifndef VERTICA_UDFS_COMMON_HPP
+#define VERTICA_UDFS_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstddef>
+#include <cstdint>
+#include "common_const.hpp"
+#include "seed_hash.hpp"
+#include "sketch_cache.hpp"
+#include "trace.hpp"
+
+using namespace Vertica;
+
+uint64_t readSeed(ServerInterface &serverInterface);
+
+uint32_t readCacheSize(ServerInterface &serverInterface);
+
+/**
+ * Worker threads of a function, by default as many as hardware threads.
+ */
+unsigned readThreads(ServerInterface &serverInterface);
+
+size_t readWindow(ServerInterface &serverInterface);
+
+void addSeedParameter(SizedColumnTypes &parameterTypes);
+
+void addCacheSizeParameter(SizedColumnTypes &parameterTypes);
+
+void addThreadsParameter(SizedColumnTypes &parameterTypes,
+                         const char *comment = "Worker threads, as many as hardware threads by default.");
+
+void addWindowParameter(SizedColumnTypes &parameterTypes);
+
+#endif //VERTICA_UDFS_COMMON_HPP
@@ -0,0 +1,15 @@
+#ifndef VERTICA_UDFS_COMMON_CONST_H
+#define VERTICA_UDFS_COMMON_CONST_H
+
+// Parameters shared by all sketch families, see common.hpp.
+#define DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME "logK"
+#define DATASKETCHES_SEED_PARAMETER_NAME "seed"
+#define DATASKETCHES_SEED_DEFAULT 9001
+#define DATASKETCHES_CACHE_SIZE_PARAMETER_NAME "cacheSize"
+#define DATASKETCHES_CACHE_SIZE_DEFAULT 16
+#define DATASKETCHES_CACHE_SIZE_MAX 4096
+#define DATASKETCHES_THREADS_PARAMETER_NAME "threads"
+#define DATASKETCHES_THREADS_MAX 256
+#define DATASKETCHES_WINDOW_PARAMETER_NAME "window"
+
+#endif //VERTICA_UDFS_COMMON_CONST_H
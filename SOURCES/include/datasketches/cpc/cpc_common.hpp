@@ -0,0 +1,189 @@
+#ifndef VERTICA_UDFS_CPC_COMMON_HPP
+#define VERTICA_UDFS_CPC_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstdint>
+#include <cpc_sketch.hpp>
+#include <cpc_union.hpp>
+#include "cpc_const.hpp"
+#include "../common.hpp"
+#include "../serialize.hpp"
+#include "../trace.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+uint8_t readCpcLogK(ServerInterface &serverInterface);
+
+/**
+ * Upper bound of a serialized sketch of the given logK. CPC sketches are compressed, so their actual size is only
+ * known once serialized.
+ */
+uint32_t cpcSketchMaxSize(uint8_t logK);
+
+/**
+ * Serializes sketch straight into out.
+ */
+inline void serializeCpcSketch(const datasketches::cpc_sketch &sketch, VString &out) {
+    serializeToVString(out, cpcSketchMaxSize(sketch.get_lg_k()), [&sketch](std::ostream &os) {
+        sketch.serialize(os);
+    });
+}
+
+/**
+ * Items policies read the first argument column into the sketch. NULL values are skipped, and so are empty
+ * strings, as cpc_sketch does for empty std::string values but not through update(data, length).
+ */
+struct CpcBytesItems {
+    void update(datasketches::cpc_sketch &sketch, BlockReader &argReader) {
+        const VString &value = argReader.getStringRef(0);
+        if (value.isNull() || value.length() == 0) {
+            return;
+        }
+        sketch.update(value.data(), value.length());
+    }
+};
+
+struct CpcVarcharItems : public CpcBytesItems {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addVarchar();
+    }
+};
+
+struct CpcVarbinaryItems : public CpcBytesItems {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addVarbinary();
+    }
+};
+
+struct CpcIntItems {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addInt();
+    }
+
+    void update(datasketches::cpc_sketch &sketch, BlockReader &argReader) {
+        const vint value = argReader.getIntRef(0);
+        if (value == vint_null) {
+            return;
+        }
+        sketch.update(static_cast<int64_t>(value));
+    }
+};
+
+/**
+ * Scalar function reading serialized sketches through a per instance cache, as theta scalar functions do.
+ */
+class CpcSketchScalarFunction : public ScalarFunction {
+protected:
+    uint64_t seed;
+    uint8_t traceLevel;
+    SketchCache<datasketches::cpc_sketch> cache;
+
+    SketchCache<datasketches::cpc_sketch>::sketch_ptr getSketch(const VString &bytes) {
+        uint64_t sketchSeed = seed;
+        return cache.get(bytes.data(), bytes.length(), [sketchSeed](const char *data, size_t length) {
+            return datasketches::cpc_sketch::deserialize(data, length, sketchSeed);
+        });
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->seed = readSeed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->cache.setCapacity(readCacheSize(srvInterface));
+    }
+
+    virtual void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        LogTrace(traceLevel, TRACE_INFO, srvInterface, "sketch cache: %llu hits, %llu misses",
+                 (unsigned long long) cache.getHits(), (unsigned long long) cache.getMisses());
+    }
+};
+
+class CpcSketchAggregateFunctionFactory : public AggregateFunctionFactory {
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        uint8_t logK = readCpcLogK(srvInterface);
+        intermediateTypeMetaData.addLongVarbinary(cpcSketchMaxSize(logK));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        uint8_t logK = readCpcLogK(srvfloaterface);
+        outputTypes.addLongVarbinary(cpcSketchMaxSize(logK));
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addSeedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+class CpcSketchAggregateFunction : public AggregateFunction {
+protected:
+    uint8_t logK;
+    uint64_t seed;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->logK = readCpcLogK(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            datasketches::cpc_sketch sketch(logK, seed);
+            serializeCpcSketch(sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            datasketches::cpc_union u(logK, seed);
+            u.update(datasketches::cpc_sketch::deserialize(aggs.getStringRef(0).data(),
+                                                           aggs.getStringRef(0).length(), seed));
+            int merged = 0;
+            do {
+                u.update(datasketches::cpc_sketch::deserialize(aggsOther.getStringRef(0).data(),
+                                                               aggsOther.getStringRef(0).length(), seed));
+                merged++;
+            } while (aggsOther.next());
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "cpc combine: merged %d sketches", merged);
+
+            serializeCpcSketch(u.get_result(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void terminate(ServerInterface &srvInterface,
+                           BlockWriter &resWriter,
+                           IntermediateAggs &aggs) override {
+        try {
+            const VString &concat = aggs.getStringRef(0);
+            VString &result = resWriter.getStringRef();
+            result.copy(&concat);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
+        }
+    }
+};
+
+#endif //VERTICA_UDFS_CPC_COMMON_HPP
@@ -0,0 +1,11 @@
+#ifndef VERTICA_UDFS_CPC_CONST_H
+#define VERTICA_UDFS_CPC_CONST_H
+
+// CPC sketches read the same logK parameter as theta sketches, with the bounds of datasketches cpc_sketch.
+#define DATASKETCHES_CPC_LOG_K_DEFAULT 11
+#define DATASKETCHES_CPC_LOG_K_MIN 4
+#define DATASKETCHES_CPC_LOG_K_MAX 26
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_CPC_MAX_SERIALIZED_SIZE 32000000
+
+#endif //VERTICA_UDFS_CPC_CONST_H
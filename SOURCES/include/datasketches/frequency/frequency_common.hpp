@@ -0,0 +1,258 @@
+#ifndef VERTICA_UDFS_FREQUENCY_COMMON_HPP
+#define VERTICA_UDFS_FREQUENCY_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstdint>
+#include <sstream>
+#include "frequency_const.hpp"
+#include "frequency_def.hpp"
+#include "../serialize.hpp"
+#include "../trace.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+uint32_t readTopK(ServerInterface &serverInterface);
+
+datasketches::frequent_items_error_type readErrorType(ServerInterface &serverInterface);
+
+vint readLimit(ServerInterface &serverInterface);
+
+/**
+ * Smallest map able to track topK items, the sketch keeping at most 3/4 of its slots active.
+ */
+uint8_t frequencyLgMaxMapSize(uint32_t topK);
+
+/**
+ * Upper bound of a serialized sketch holding items of at most maxItemSize bytes each.
+ */
+uint32_t frequencySketchMaxSize(uint32_t topK, size_t maxItemSize);
+
+/**
+ * Items policies read the first argument column into the sketch with the given weight (update), and write a tracked
+ * item to an output column (addOutputType / setOutput). itemSize is the serialized size of fixed width items,
+ * 0 for variable width ones.
+ * VARCHAR values are read into a reused buffer: the sketch only copies the key when it is not tracked yet,
+ * hence rows of an already tracked item do not allocate.
+ */
+struct FrequencyVarcharItems {
+    typedef frequent_strings_sketch sketch_type;
+
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addVarchar();
+    }
+
+    static size_t maxItemSize(const VerticaType &type) {
+        return sizeof(uint32_t) + type.getStringLength();
+    }
+
+    static const size_t itemSize = 0;
+
+    static void addOutputType(SizedColumnTypes &outputTypes, const char *name) {
+        outputTypes.addVarchar(DATASKETCHES_FREQUENCY_MAX_ITEM_LENGTH, name);
+    }
+
+    static void setOutput(PartitionWriter &outputWriter, size_t column, const std::string &value) {
+        outputWriter.getStringRef(column).copy(value);
+    }
+
+    std::string item;
+
+    void update(sketch_type &sketch, BlockReader &argReader, uint64_t weight = 1) {
+        const VString &value = argReader.getStringRef(0);
+        if (value.isNull()) {
+            return;
+        }
+        item.assign(value.data(), value.length());
+        sketch.update(item, weight);
+    }
+};
+
+struct FrequencyIntItems {
+    typedef frequent_longs_sketch sketch_type;
+
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addInt();
+    }
+
+    static size_t maxItemSize(const VerticaType &type) {
+        return sizeof(int64_t);
+    }
+
+    static const size_t itemSize = sizeof(int64_t);
+
+    static void addOutputType(SizedColumnTypes &outputTypes, const char *name) {
+        outputTypes.addInt(name);
+    }
+
+    static void setOutput(PartitionWriter &outputWriter, size_t column, int64_t value) {
+        outputWriter.setInt(column, value);
+    }
+
+    void update(sketch_type &sketch, BlockReader &argReader, uint64_t weight = 1) {
+        const vint value = argReader.getIntRef(0);
+        if (value == vint_null) {
+            return;
+        }
+        sketch.update(static_cast<int64_t>(value), weight);
+    }
+};
+
+struct FrequencyUuidItems {
+    typedef frequent_uuids_sketch sketch_type;
+
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addUuid();
+    }
+
+    static size_t maxItemSize(const VerticaType &type) {
+        return sizeof(uuid_item);
+    }
+
+    static const size_t itemSize = sizeof(uuid_item);
+
+    // UUIDs are returned in their canonical text form.
+    static void addOutputType(SizedColumnTypes &outputTypes, const char *name) {
+        outputTypes.addVarchar(36, name);
+    }
+
+    static void setOutput(PartitionWriter &outputWriter, size_t column, const uuid_item &value) {
+        ostringstream os;
+        os << value;
+        outputWriter.getStringRef(column).copy(os.str());
+    }
+
+    uuid_item item;
+
+    void update(sketch_type &sketch, BlockReader &argReader, uint64_t weight = 1) {
+        const VUuid &value = argReader.getUuidRef(0);
+        if (value.isNull()) {
+            return;
+        }
+        std::memcpy(item.bytes, &value, sizeof(item.bytes));
+        sketch.update(item, weight);
+    }
+};
+
+/**
+ * Adds an INTEGER weight argument to Items, for (item, count) rows of pre-aggregated tables.
+ * Rows with a NULL or zero weight are skipped.
+ */
+template<class Items>
+struct FrequencyWeighted : public Items {
+    typedef typename Items::sketch_type sketch_type;
+
+    static void addArgumentType(ColumnTypes &argTypes) {
+        Items::addArgumentType(argTypes);
+        argTypes.addInt();
+    }
+
+    void update(sketch_type &sketch, BlockReader &argReader) {
+        const vint weight = argReader.getIntRef(1);
+        if (weight == vint_null || weight == 0) {
+            return;
+        }
+        if (weight < 0) {
+            throw std::invalid_argument("weights must be positive");
+        }
+        Items::update(sketch, argReader, static_cast<uint64_t>(weight));
+    }
+};
+
+/**
+ * Upper bound of a merge of sketches tracking topK items: unknown for variable width items.
+ */
+template<class Items>
+uint32_t frequencyMergedSketchMaxSize(uint32_t topK) {
+    return Items::itemSize == 0 ? DATASKETCHES_FREQUENCY_MAX_SERIALIZED_SIZE
+                                : frequencySketchMaxSize(topK, Items::itemSize);
+}
+
+/**
+ * Serializes sketch straight into out.
+ */
+template<class Sketch>
+void serializeFrequencySketch(const Sketch &sketch, VString &out) {
+    const typename frequency_item_serde<Sketch>::type serde;
+    serializeToVString(out, sketch.get_serialized_size_bytes(serde), [&sketch, &serde](std::ostream &os) {
+        sketch.serialize(os, serde);
+    });
+}
+
+template<class Sketch>
+Sketch deserializeFrequencySketch(const char *data, size_t length) {
+    return Sketch::deserialize(data, length, typename frequency_item_serde<Sketch>::type());
+}
+
+template<class Sketch>
+class FrequencySketchAggregateFunction : public AggregateFunction {
+protected:
+    uint32_t topK;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->topK = readTopK(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            Sketch sketch(frequencyLgMaxMapSize(topK));
+            serializeFrequencySketch(sketch, aggs.getStringRef(0)); // provides compact & rebuild sketch <=> min size
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            Sketch u = deserializeFrequencySketch<Sketch>(aggs.getStringRef(0).data(), aggs.getStringRef(0).length());
+            int merged = 0;
+            do {
+                Sketch um = deserializeFrequencySketch<Sketch>(aggsOther.getStringRef(0).data(), aggsOther.getStringRef(0).length());
+                u.merge(um);
+                merged++;
+            } while (aggsOther.next());
+
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "frequency combine: merged %d sketches into %u active items",
+                     merged, u.get_num_active_items());
+            serializeFrequencySketch(u, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void terminate(ServerInterface &srvInterface,
+                           BlockWriter &resWriter,
+                           IntermediateAggs &aggs) override {
+        try {
+            const VString &concat = aggs.getStringRef(0);
+            VString &result = resWriter.getStringRef();
+            result.copy(&concat);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
+        }
+    }
+};
+
+class FrequencySketchAggregateFunctionFactory : public AggregateFunctionFactory {
+protected:
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties topKProps;
+        topKProps.required = false;
+        topKProps.canBeNull = false;
+        topKProps.comment = "Number of items to track.";
+        parameterTypes.addInt(DATASKETCHES_TOP_K_PARAMETER_NAME, topKProps);
+
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+#endif //VERTICA_UDFS_FREQUENCY_COMMON_HPP
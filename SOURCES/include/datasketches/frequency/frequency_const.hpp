@@ -0,0 +1,17 @@
+#ifndef VERTICA_UDFS_FREQUENCY_CONST_H
+#define VERTICA_UDFS_FREQUENCY_CONST_H
+
+#define DATASKETCHES_TOP_K_PARAMETER_NAME "topK"
+#define DATASKETCHES_TOP_K_DEFAULT 1000
+#define DATASKETCHES_TOP_K_MIN 1
+#define DATASKETCHES_TOP_K_MAX 1000000
+// frequent_items_sketch cannot go below a map of 2^3 slots.
+#define DATASKETCHES_FREQUENCY_LG_MIN_MAP_SIZE 3
+#define DATASKETCHES_ERROR_TYPE_PARAMETER_NAME "errorType"
+#define DATASKETCHES_LIMIT_PARAMETER_NAME "limit"
+// Vertica supports maximum 65000 bytes in a VARCHAR field.
+#define DATASKETCHES_FREQUENCY_MAX_ITEM_LENGTH 65000
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_FREQUENCY_MAX_SERIALIZED_SIZE 32000000
+
+#endif //VERTICA_UDFS_FREQUENCY_CONST_H
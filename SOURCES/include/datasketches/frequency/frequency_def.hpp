@@ -0,0 +1,104 @@
+#ifndef VERTICA_UDFS_FREQUENCY_DEF_HPP
+#define VERTICA_UDFS_FREQUENCY_DEF_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <stdexcept>
+#include <frequent_items_sketch.hpp>
+
+/**
+ * Fixed width key used to track UUID values without going through their string form.
+ */
+struct uuid_item {
+    uint8_t bytes[16];
+
+    bool operator==(const uuid_item &other) const {
+        return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+    }
+};
+
+struct uuid_item_hash {
+    size_t operator()(const uuid_item &item) const {
+        uint64_t hi, lo;
+        std::memcpy(&hi, item.bytes, sizeof(hi));
+        std::memcpy(&lo, item.bytes + sizeof(hi), sizeof(lo));
+        return static_cast<size_t>(hi ^ (lo * 0x9E3779B97F4A7C15ULL));
+    }
+};
+
+/**
+ * Prints the canonical 8-4-4-4-12 hexadecimal representation.
+ */
+inline std::ostream &operator<<(std::ostream &os, const uuid_item &item) {
+    static const char *digits = "0123456789abcdef";
+    char out[36];
+    size_t pos = 0;
+    for (size_t i = 0; i < sizeof(item.bytes); i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            out[pos++] = '-';
+        }
+        out[pos++] = digits[item.bytes[i] >> 4];
+        out[pos++] = digits[item.bytes[i] & 0x0f];
+    }
+    return os.write(out, sizeof(out));
+}
+
+/**
+ * Serializer for uuid_item following the datasketches serde interface: items are written as raw 16 bytes.
+ */
+struct uuid_item_serde {
+    void serialize(std::ostream &os, const uuid_item *items, unsigned num) const {
+        os.write(reinterpret_cast<const char *>(items), sizeof(uuid_item) * num);
+    }
+
+    void deserialize(std::istream &is, uuid_item *items, unsigned num) const {
+        is.read(reinterpret_cast<char *>(items), sizeof(uuid_item) * num);
+        if (!is.good()) throw std::runtime_error("error reading from std::istream");
+    }
+
+    size_t serialize(void *ptr, size_t capacity, const uuid_item *items, unsigned num) const {
+        const size_t bytes = sizeof(uuid_item) * num;
+        if (bytes > capacity) throw std::out_of_range("insufficient capacity to serialize items");
+        std::memcpy(ptr, items, bytes);
+        return bytes;
+    }
+
+    size_t deserialize(const void *ptr, size_t capacity, uuid_item *items, unsigned num) const {
+        const size_t bytes = sizeof(uuid_item) * num;
+        if (bytes > capacity) throw std::out_of_range("insufficient data to deserialize items");
+        std::memcpy(items, ptr, bytes);
+        return bytes;
+    }
+
+    size_t size_of_item(const uuid_item &) const {
+        return sizeof(uuid_item);
+    }
+};
+
+typedef datasketches::frequent_items_sketch<std::string> frequent_strings_sketch;
+typedef datasketches::frequent_items_sketch<int64_t> frequent_longs_sketch;
+typedef datasketches::frequent_items_sketch<uuid_item, uint64_t, uuid_item_hash> frequent_uuids_sketch;
+
+/**
+ * Serde of the items of a sketch type, to pass to its (de)serialization methods: the sketch type itself does not
+ * carry it.
+ */
+template<class Sketch>
+struct frequency_item_serde {
+    typedef datasketches::serde<std::string> type;
+};
+
+template<>
+struct frequency_item_serde<frequent_longs_sketch> {
+    typedef datasketches::serde<int64_t> type;
+};
+
+template<>
+struct frequency_item_serde<frequent_uuids_sketch> {
+    typedef uuid_item_serde type;
+};
+
+#endif //VERTICA_UDFS_FREQUENCY_DEF_HPP
@@ -0,0 +1,24 @@
+#ifndef VERTICA_UDFS_HLL_COMMON_HPP
+#define VERTICA_UDFS_HLL_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstdint>
+#include <hll.hpp>
+#include "hll_const.hpp"
+#include "../common.hpp"
+
+using namespace Vertica;
+
+uint8_t readHllLogK(ServerInterface &serverInterface);
+
+/**
+ * Upper bound of a serialized sketch of the given logK, whatever its target type.
+ */
+uint32_t hllSketchMaxSize(uint8_t logK);
+
+/**
+ * Serializes sketch in compact form straight into out.
+ */
+void serializeHllSketch(const datasketches::hll_sketch &sketch, VString &out);
+
+#endif //VERTICA_UDFS_HLL_COMMON_HPP
@@ -0,0 +1,11 @@
+#ifndef VERTICA_UDFS_HLL_CONST_H
+#define VERTICA_UDFS_HLL_CONST_H
+
+// HLL sketches read the same logK parameter as theta sketches, with the bounds of datasketches hll_sketch.
+#define DATASKETCHES_HLL_LOG_K_DEFAULT 12
+#define DATASKETCHES_HLL_LOG_K_MIN 4
+#define DATASKETCHES_HLL_LOG_K_MAX 21
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_HLL_MAX_SERIALIZED_SIZE 32000000
+
+#endif //VERTICA_UDFS_HLL_CONST_H
@@ -0,0 +1,107 @@
+#ifndef VERTICA_UDFS_HLL_MAP_HPP
+#define VERTICA_UDFS_HLL_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Approximate distinct counts for a large number of keys in a single hash table, in the spirit of
+ * the UniqueCountMap of DataSketches Java.
+ *
+ * Values are reduced to the same 32 bits coupons as datasketches HLL sketches (26 bits address, 6 bits value).
+ * Every key starts with up to 2 coupons stored inline in its 24 bytes entry, then moves to a coupon hash set
+ * allocated in a shared arena, doubling up to 256 slots, and finally to 1024 HLL registers with a HIP estimator
+ * once it holds more than 192 coupons. Key bytes are stored once in a shared arena as well.
+ * Counts are exact (up to coupon collisions) until the HLL stage, where the relative error is about 2.6%.
+ */
+class hll_map {
+public:
+    static const uint8_t INLINE_COUPONS = 2;
+    static const uint8_t LG_MIN_SET_SIZE = 3;
+    static const uint8_t LG_MAX_SET_SIZE = 8;
+    static const uint8_t LG_HLL_K = 10;
+
+    explicit hll_map(uint8_t lgInitialSize = 10);
+
+    /**
+     * Hashes value as datasketches HLL sketches do and adds it to the distinct values of key.
+     * Empty values are ignored, as in datasketches.
+     */
+    void update(const void *key, size_t keyLength, const void *value, size_t valueLength);
+
+    void updateCoupon(const void *key, size_t keyLength, uint32_t coupon);
+
+    double getEstimate(const void *key, size_t keyLength) const;
+
+    size_t getNumKeys() const;
+
+    /**
+     * Bytes held by the table and its arenas.
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * Calls f(const char *key, size_t keyLength, double estimate) for every key.
+     */
+    template<typename F>
+    void forEach(F f) const {
+        for (const Entry &entry: entries) {
+            if (entry.stage != EMPTY) {
+                f(keys.data() + entry.keyOffset, entry.keyLength, estimate(entry));
+            }
+        }
+    }
+
+    static uint32_t coupon(const void *value, size_t valueLength);
+
+private:
+    enum Stage : uint8_t {
+        EMPTY = 0, INLINE = 1, SET = 2, HLL = 3
+    };
+
+    struct Entry {
+        uint32_t fingerprint;
+        uint32_t keyOffset;
+        uint16_t keyLength;
+        Stage stage;
+        uint8_t lgSetSize;
+        uint32_t count;
+        // INLINE: the coupons themselves, SET: offset of the coupon set, HLL: index of the registers.
+        uint32_t slots[INLINE_COUPONS];
+    };
+
+    uint8_t lgSize;
+    size_t numKeys;
+    std::vector<Entry> entries;
+    std::vector<char> keys;
+    std::vector<uint32_t> couponSets;
+    std::vector<uint32_t> freeSets[LG_MAX_SET_SIZE + 1];
+    std::vector<uint8_t> registers;
+    // HIP estimate and kxq for every HLL.
+    std::vector<double> hipStates;
+
+    static uint32_t fingerprint(const void *key, size_t keyLength);
+
+    size_t find(uint32_t fingerprint, const void *key, size_t keyLength) const;
+
+    Entry &findOrInsert(const void *key, size_t keyLength);
+
+    void grow();
+
+    uint32_t allocateSet(uint8_t lgSetSize);
+
+    void releaseSet(uint32_t offset, uint8_t lgSetSize);
+
+    static bool insertInSet(uint32_t *set, uint8_t lgSetSize, uint32_t coupon);
+
+    void addToSet(Entry &entry, uint32_t coupon);
+
+    void promoteToHll(Entry &entry, const uint32_t *coupons, uint32_t numCoupons);
+
+    void addToHll(uint32_t hllIndex, uint32_t coupon);
+
+    double estimate(const Entry &entry) const;
+};
+
+#endif //VERTICA_UDFS_HLL_MAP_HPP
@@ -0,0 +1,219 @@
+#ifndef VERTICA_UDFS_KLL_COMMON_HPP
+#define VERTICA_UDFS_KLL_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "kll_const.hpp"
+#include "kll_def.hpp"
+#include "../common.hpp"
+#include "../serialize.hpp"
+#include "../trace.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+uint16_t readKllK(ServerInterface &serverInterface);
+
+/**
+ * Upper bound of a serialized sketch of the given k. The number of retained values only grows with the log of
+ * the number of updates, so the bound is taken for 2^48 of them.
+ */
+uint32_t kllSketchMaxSize(uint16_t k);
+
+/**
+ * Serializes sketch straight into out.
+ */
+inline void serializeKllSketch(const kll_sketch_custom &sketch, VString &out) {
+    serializeToVString(out, sketch.get_serialized_size_bytes(), [&sketch](std::ostream &os) {
+        sketch.serialize(os);
+    });
+}
+
+/**
+ * Parses a list of numbers separated by commas, optionally within square brackets, e.g. '[0.5,0.9,0.99]'.
+ * Throws std::invalid_argument on anything else.
+ */
+void parseDoubleList(const std::string &text, std::vector<double> &values);
+
+/**
+ * Formats values as '[v1,v2,...]', the list format of frequency_sketch_create.
+ */
+template<typename Values>
+std::string formatDoubleList(const Values &values) {
+    std::string text = "[";
+    char buffer[32];
+    for (size_t i = 0; i < values.size(); i++) {
+        snprintf(buffer, sizeof(buffer), i == 0 ? "%.17g" : ",%.17g", static_cast<double>(values[i]));
+        text += buffer;
+    }
+    text += "]";
+    return text;
+}
+
+/**
+ * Values policies update the sketch with the non NULL values of the first argument column of a whole block, and
+ * return how many they added.
+ */
+struct KllFloatValues {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addFloat();
+    }
+
+    static size_t update(kll_sketch_custom &sketch, BlockReader &argReader) {
+        size_t count = 0;
+        do {
+            const vfloat value = argReader.getFloatRef(0);
+            if (!vfloatIsNull(value)) {
+                sketch.update(value);
+                count++;
+            }
+        } while (argReader.next());
+        return count;
+    }
+};
+
+struct KllIntValues {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addInt();
+    }
+
+    static size_t update(kll_sketch_custom &sketch, BlockReader &argReader) {
+        size_t count = 0;
+        do {
+            const vint value = argReader.getIntRef(0);
+            if (value != vint_null) {
+                sketch.update(static_cast<double>(value));
+                count++;
+            }
+        } while (argReader.next());
+        return count;
+    }
+};
+
+/**
+ * Scalar function reading serialized sketches through a per instance cache, as theta scalar functions do.
+ */
+class KllSketchScalarFunction : public ScalarFunction {
+protected:
+    uint8_t traceLevel;
+    SketchCache<kll_sketch_custom> cache;
+
+    SketchCache<kll_sketch_custom>::sketch_ptr getSketch(const VString &bytes) {
+        return cache.get(bytes.data(), bytes.length(), [](const char *data, size_t length) {
+            return kll_sketch_custom::deserialize(data, length);
+        });
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->cache.setCapacity(readCacheSize(srvInterface));
+    }
+
+    virtual void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        LogTrace(traceLevel, TRACE_INFO, srvInterface, "sketch cache: %llu hits, %llu misses",
+                 (unsigned long long) cache.getHits(), (unsigned long long) cache.getMisses());
+    }
+};
+
+class KllSketchScalarFunctionFactory : public ScalarFunctionFactory {
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+class KllSketchAggregateFunctionFactory : public AggregateFunctionFactory {
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        uint16_t k = readKllK(srvInterface);
+        intermediateTypeMetaData.addLongVarbinary(kllSketchMaxSize(k));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        uint16_t k = readKllK(srvfloaterface);
+        outputTypes.addLongVarbinary(kllSketchMaxSize(k));
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties kProps;
+        kProps.required = false;
+        kProps.canBeNull = false;
+        kProps.comment = "Size of the sketch, controls the rank error.";
+        parameterTypes.addInt(DATASKETCHES_KLL_K_PARAMETER_NAME, kProps);
+
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+/**
+ * Base of KLL aggregates: the sketch stays live across the blocks of a group and is only serialized at the end
+ * of each block. Intermediates are merged into the first one.
+ */
+class KllSketchAggregateFunction : public AggregateFunction {
+protected:
+    uint16_t k;
+    uint8_t traceLevel;
+    std::unique_ptr<kll_sketch_custom> sketch;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->k = readKllK(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            sketch.reset(new kll_sketch_custom(k));
+            serializeKllSketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            auto merged = kll_sketch_custom::deserialize(aggs.getStringRef(0).data(), aggs.getStringRef(0).length());
+            int count = 0;
+            do {
+                merged.merge(kll_sketch_custom::deserialize(aggsOther.getStringRef(0).data(),
+                                                            aggsOther.getStringRef(0).length()));
+                count++;
+            } while (aggsOther.next());
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "kll combine: merged %d sketches, n=%llu", count,
+                     (unsigned long long) merged.get_n());
+
+            serializeKllSketch(merged, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void terminate(ServerInterface &srvInterface,
+                           BlockWriter &resWriter,
+                           IntermediateAggs &aggs) override {
+        try {
+            const VString &concat = aggs.getStringRef(0);
+            VString &result = resWriter.getStringRef();
+            result.copy(&concat);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
+        }
+    }
+};
+
+#endif //VERTICA_UDFS_KLL_COMMON_HPP
@@ -0,0 +1,12 @@
+#ifndef VERTICA_UDFS_KLL_CONST_H
+#define VERTICA_UDFS_KLL_CONST_H
+
+#define DATASKETCHES_KLL_K_PARAMETER_NAME "k"
+// Bounds of datasketches kll_sketch, 200 gives a normalized rank error of about 1.65%.
+#define DATASKETCHES_KLL_K_DEFAULT 200
+#define DATASKETCHES_KLL_K_MIN 8
+#define DATASKETCHES_KLL_K_MAX 65535
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_KLL_MAX_SERIALIZED_SIZE 32000000
+
+#endif //VERTICA_UDFS_KLL_CONST_H
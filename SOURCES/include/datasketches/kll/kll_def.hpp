@@ -0,0 +1,11 @@
+#ifndef VERTICA_UDFS_KLL_DEF_HPP
+#define VERTICA_UDFS_KLL_DEF_HPP
+
+#include <functional>
+#include <kll_sketch.hpp>
+#include "../custom_alloc.hpp"
+
+// FLOAT and INTEGER values share sketches of doubles, integers are exact up to 2^53.
+typedef datasketches::kll_sketch<double, std::less<double>, custom_alloc<double>> kll_sketch_custom;
+
+#endif //VERTICA_UDFS_KLL_DEF_HPP
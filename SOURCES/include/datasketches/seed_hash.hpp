@@ -0,0 +1,22 @@
+#ifndef VERTICA_UDFS_SEED_HASH_HPP
+#define VERTICA_UDFS_SEED_HASH_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <MurmurHash3.h>
+
+/**
+ * 16 bits hash of a seed, as stored by datasketches in serialized sketches and by bloom filters, to refuse mixing
+ * data hashed with different seeds.
+ */
+inline uint16_t computeSeedHash(uint64_t seed) {
+    HashState hashes;
+    MurmurHash3_x64_128(&seed, sizeof(seed), 0, hashes);
+    const uint16_t seedHash = hashes.h1 & 0xffff;
+    if (seedHash == 0) {
+        throw std::invalid_argument("The given seed results in a seed hash of zero, please use another seed");
+    }
+    return seedHash;
+}
+
+#endif //VERTICA_UDFS_SEED_HASH_HPP
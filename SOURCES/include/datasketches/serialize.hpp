@@ -0,0 +1,43 @@
+#ifndef VERTICA_UDFS_SERIALIZE_HPP
+#define VERTICA_UDFS_SERIALIZE_HPP
+
+#include <Vertica.h>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+
+using namespace Vertica;
+
+/**
+ * Output stream buffer over a fixed size memory area. Writing past its end fails the stream.
+ */
+class FixedBufferStreamBuf : public std::streambuf {
+public:
+    FixedBufferStreamBuf(char *data, size_t size) {
+        setp(data, data + size);
+    }
+
+    size_t written() const {
+        return pptr() - pbase();
+    }
+};
+
+/**
+ * Serializes in place into out for sketches that serialize to a std::ostream, instead of going through a
+ * temporary vector: out is allocated once with size bytes, which must be at least the serialized size
+ * (get_compact_serialization_bytes(), get_serialized_size_bytes()...), and write(std::ostream &) fills it.
+ */
+template<typename Write>
+void serializeToVString(VString &out, size_t size, Write write) {
+    out.alloc(size);
+    FixedBufferStreamBuf buffer(out.data(), size);
+    std::ostream os(&buffer);
+    write(os);
+    if (!os.good()) {
+        throw std::length_error("serialized sketch does not fit in its expected size");
+    }
+    out.setLen(buffer.written());
+}
+
+#endif //VERTICA_UDFS_SERIALIZE_HPP
@@ -0,0 +1,137 @@
+#ifndef VERTICA_UDFS_SKETCH_CACHE_HPP
+#define VERTICA_UDFS_SKETCH_CACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <MurmurHash3.h>
+
+/**
+ * Bounded LRU cache of deserialized sketches, keyed by their serialized bytes.
+ *
+ * Lookups first check the bytes of the previous lookup by pointer and length, which only holds within a block
+ * (newBlock() must be called whenever the input memory may have changed). Otherwise bytes are fingerprinted from
+ * their length and their first and last bytes, and compared in full on a fingerprint match.
+ * Sketches are handed out as shared pointers so that they survive an eviction while still in use.
+ */
+template<typename Sketch>
+class SketchCache {
+public:
+    typedef std::shared_ptr<const Sketch> sketch_ptr;
+
+    explicit SketchCache(size_t capacity = 0) : capacity(capacity), hits(0), misses(0) {
+        newBlock();
+    }
+
+    void setCapacity(size_t newCapacity) {
+        capacity = newCapacity;
+        while (entries.size() > capacity) {
+            evict();
+        }
+        newBlock();
+    }
+
+    void newBlock() {
+        lastData = nullptr;
+        lastLength = 0;
+    }
+
+    /**
+     * Returns the sketch for the given bytes, calling deserialize(data, length) on a miss only.
+     */
+    template<typename Deserializer>
+    sketch_ptr get(const char *data, size_t length, Deserializer deserialize) {
+        if (capacity == 0) {
+            misses++;
+            return sketch_ptr(new Sketch(deserialize(data, length)));
+        }
+        if (data == lastData && length == lastLength) {
+            hits++;
+            return lastSketch;
+        }
+
+        const uint64_t key = fingerprint(data, length);
+        auto range = index.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto entry = it->second;
+            if (entry->bytes.size() == length && std::memcmp(entry->bytes.data(), data, length) == 0) {
+                hits++;
+                entries.splice(entries.begin(), entries, entry);
+                return remember(data, length, entry->sketch);
+            }
+        }
+
+        misses++;
+        sketch_ptr sketch(new Sketch(deserialize(data, length)));
+        if (entries.size() >= capacity) {
+            evict();
+        }
+        entries.push_front(Entry{key, std::vector<char>(data, data + length), sketch});
+        index.insert(std::make_pair(key, entries.begin()));
+        return remember(data, length, sketch);
+    }
+
+    uint64_t getHits() const {
+        return hits;
+    }
+
+    uint64_t getMisses() const {
+        return misses;
+    }
+
+private:
+    static const size_t FINGERPRINT_BYTES = 32;
+
+    struct Entry {
+        uint64_t key;
+        std::vector<char> bytes;
+        sketch_ptr sketch;
+    };
+
+    size_t capacity;
+    uint64_t hits;
+    uint64_t misses;
+    // Most recently used first.
+    std::list<Entry> entries;
+    std::unordered_multimap<uint64_t, typename std::list<Entry>::iterator> index;
+    const char *lastData;
+    size_t lastLength;
+    sketch_ptr lastSketch;
+
+    static uint64_t fingerprint(const char *data, size_t length) {
+        char sample[2 * FINGERPRINT_BYTES + sizeof(uint64_t)];
+        const size_t head = length < FINGERPRINT_BYTES ? length : FINGERPRINT_BYTES;
+        const size_t tail = length - head < FINGERPRINT_BYTES ? length - head : FINGERPRINT_BYTES;
+        const uint64_t length64 = length;
+        std::memcpy(sample, &length64, sizeof(length64));
+        std::memcpy(sample + sizeof(length64), data, head);
+        std::memcpy(sample + sizeof(length64) + head, data + length - tail, tail);
+        HashState hashes;
+        MurmurHash3_x64_128(sample, sizeof(length64) + head + tail, 0, hashes);
+        return hashes.h1;
+    }
+
+    const sketch_ptr &remember(const char *data, size_t length, const sketch_ptr &sketch) {
+        lastData = data;
+        lastLength = length;
+        lastSketch = sketch;
+        return lastSketch;
+    }
+
+    void evict() {
+        auto last = std::prev(entries.end());
+        auto range = index.equal_range(last->key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == last) {
+                index.erase(it);
+                break;
+            }
+        }
+        entries.pop_back();
+    }
+};
+
+#endif //VERTICA_UDFS_SKETCH_CACHE_HPP
@@ -0,0 +1,78 @@
+#ifndef VERTICA_UDFS_SLIDING_WINDOW_HPP
+#define VERTICA_UDFS_SLIDING_WINDOW_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Union of the panes of a sliding window with two stacks, for operations that cannot be undone such as sketch
+ * unions. New panes are pushed on the back stack, whose union is kept up to date. The front stack holds the unions
+ * of the oldest panes with all the panes pushed after them up to the back stack, so that evicting the oldest pane
+ * is a pop; when it runs empty the back stack is flipped over into it. Every pane takes part in about 3 unions
+ * overall, whatever the window size.
+ *
+ * Ops provides value_type, copy constructible, and value_type combine(const value_type &older, const value_type &newer).
+ */
+template<typename Ops>
+class two_stack_window {
+public:
+    typedef typename Ops::value_type value_type;
+
+    explicit two_stack_window(const Ops &ops) : ops(ops) {
+    }
+
+    size_t size() const {
+        return front.size() + back.size();
+    }
+
+    void push(value_type &&pane) {
+        if (back.empty()) {
+            backUnion.reset(new value_type(pane));
+        } else {
+            backUnion.reset(new value_type(ops.combine(*backUnion, pane)));
+        }
+        back.push_back(std::move(pane));
+    }
+
+    /**
+     * Evicts the oldest pane.
+     */
+    void pop() {
+        if (front.empty()) {
+            for (size_t i = back.size(); i-- > 0;) {
+                if (front.empty()) {
+                    front.push_back(std::move(back[i]));
+                } else {
+                    front.push_back(ops.combine(back[i], front.back()));
+                }
+            }
+            back.clear();
+        }
+        front.pop_back();
+    }
+
+    /**
+     * Union of all the panes, the window must not be empty.
+     */
+    value_type query() const {
+        if (front.empty()) {
+            return *backUnion;
+        }
+        if (back.empty()) {
+            return front.back();
+        }
+        return ops.combine(front.back(), *backUnion);
+    }
+
+private:
+    const Ops &ops;
+    // Oldest pane on top.
+    std::vector<value_type> front;
+    // Newest pane on top.
+    std::vector<value_type> back;
+    std::unique_ptr<value_type> backUnion;
+};
+
+#endif //VERTICA_UDFS_SLIDING_WINDOW_HPP
@@ -2,78 +2,242 @@
 #define COM_CRITEO_MOAB_DATASKETCHES_VERTICA_H
 
 #include <Vertica.h>
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <vector>
 #include "theta_const.hpp"
 #include "theta_def.hpp"
+#include "theta_merge.hpp"
+#include "theta_serde.hpp"
+#include "theta_set_ops.hpp"
+#include "../common.hpp"
 
 using namespace Vertica;
 using namespace std;
 
 uint8_t readLogK(ServerInterface &serverInterface);
 
-uint64_t readSeed(ServerInterface &serverInterface);
+bool readCompressed(ServerInterface &serverInterface);
+
+float readSamplingProbability(ServerInterface &serverInterface);
+
+/**
+ * Log2 of the number of hash range shards of a sketch, see theta_shards.hpp.
+ */
+uint8_t readLgShards(ServerInterface &serverInterface);
+
+void addCompressedParameter(SizedColumnTypes &parameterTypes);
+
+void addSamplingProbabilityParameter(SizedColumnTypes &parameterTypes);
+
+void addLgShardsParameter(SizedColumnTypes &parameterTypes);
 
 uint32_t quickSelectSketchMinSize(uint8_t logK);
 
 uint32_t quickSelectSketchMaxSize(uint8_t logK);
 
+/**
+ * Size of a compact sketch of numEntries hashes, capped to what Vertica can store.
+ */
+uint32_t compactSketchMaxSize(uint64_t numEntries);
+
+/**
+ * Upper bound of the hashes of a sketch stored in columnLength bytes. Stored sketches may be in either format, so
+ * this is the bound of the compressed one, whose entries take at least 2 bytes (compact entries take 8).
+ */
+uint64_t sketchMaxEntries(vsize columnLength);
+
+/**
+ * k of a set of inputs, added one at a time. A sketch of an update sketch in estimation mode keeps at least its k
+ * hashes, and less than twice as many, so its k is the largest power of 2 not above its number of hashes. An exact
+ * sketch holds less than its k hashes. Sampled sketches and the results of intersections or differences may keep
+ * far fewer hashes than their k, so the result is never below the default logK.
+ */
+class LogKDerivation {
+    bool exact = true;
+    uint64_t numEntries = 0;
+    uint64_t maxExactEntries = 0;
+    uint64_t maxEstimationEntries = 0;
+
+    static uint8_t ceilLog2(uint64_t n) {
+        uint8_t logK = DATASKETCHES_LOG_NOMINAL_VALUE_MIN;
+        while (logK < DATASKETCHES_LOG_NOMINAL_VALUE_MAX && (1ULL << logK) < n) {
+            logK++;
+        }
+        return logK;
+    }
+
+    static uint8_t floorLog2(uint64_t n) {
+        uint8_t logK = DATASKETCHES_LOG_NOMINAL_VALUE_MIN;
+        while (logK < DATASKETCHES_LOG_NOMINAL_VALUE_MAX && (1ULL << (logK + 1)) <= n) {
+            logK++;
+        }
+        return logK;
+    }
+
+public:
+    void add(uint64_t retained, uint64_t theta) {
+        numEntries += retained;
+        if (theta < theta_serde::MAX_THETA) {
+            exact = false;
+            maxEstimationEntries = std::max(maxEstimationEntries, retained);
+        } else {
+            maxExactEntries = std::max(maxExactEntries, retained);
+        }
+    }
+
+    uint8_t getLogK() const {
+        const uint8_t logK = exact ? ceilLog2(numEntries)
+                                   : std::max(floorLog2(maxEstimationEntries), ceilLog2(maxExactEntries));
+        return std::max<uint8_t>(logK, DATASKETCHES_LOG_NOMINAL_VALUE_DEFAULT);
+    }
+};
+
+/**
+ * Serializes sketch (update or compact) as an ordered compact sketch straight into out, or in the compressed
+ * format when compressed is set and the sketch is ordered.
+ */
+template<typename Sketch>
+void serializeThetaSketch(const Sketch &sketch, VString &out, bool compressed = false) {
+    if (compressed) {
+        out.alloc(compressedThetaSerializedSize(sketch));
+        out.setLen(serializeCompressedTheta(sketch, out.data()));
+    } else {
+        out.alloc(compactThetaSerializedSize(sketch));
+        out.setLen(serializeCompactTheta(sketch, out.data()));
+    }
+}
+
+/**
+ * Deserializes a sketch in either the compact or the compressed format. All functions read their input
+ * sketches through this.
+ */
+compact_theta_sketch_custom deserializeThetaSketch(const char *data, size_t length, uint64_t seed);
+
+
+/**
+ * Scalar function reading serialized sketches through a per instance cache, as the same stored sketch often
+ * reaches a function many times (joins, overlap matrices...).
+ */
+class ThetaSketchScalarFunction : public ScalarFunction {
+protected:
+    uint64_t seed;
+    uint16_t seedHash;
+    uint8_t traceLevel;
+    bool compressed;
+    // Scalar functions already run on every Vertica thread: set operations only start threads of their own,
+    // splitting their inputs in hash range shards (see theta_shards.hpp), when given a threads parameter.
+    unsigned threads;
+    SketchCache<compact_theta_sketch_custom> cache;
+    // Inputs as sorted hashes, for the sharded set operations.
+    SketchCache<theta_hashes> hashesCache;
 
+    SketchCache<compact_theta_sketch_custom>::sketch_ptr getSketch(const VString &bytes) {
+        uint64_t sketchSeed = seed;
+        return cache.get(bytes.data(), bytes.length(), [sketchSeed](const char *data, size_t length) {
+            return deserializeThetaSketch(data, length, sketchSeed);
+        });
+    }
+
+    SketchCache<theta_hashes>::sketch_ptr getHashes(const VString &bytes) {
+        uint64_t sketchSeed = seed;
+        return hashesCache.get(bytes.data(), bytes.length(), [sketchSeed](const char *data, size_t length) {
+            return theta_hashes(deserializeThetaSketch(data, length, sketchSeed));
+        });
+    }
+
+    void newBlock() {
+        cache.newBlock();
+        hashesCache.newBlock();
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->seed = readSeed(srvInterface);
+        this->seedHash = computeSeedHash(seed);
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->threads = srvInterface.getParamReader().containsParameter(DATASKETCHES_THREADS_PARAMETER_NAME)
+                        ? readThreads(srvInterface) : 1;
+        this->cache.setCapacity(readCacheSize(srvInterface));
+        this->hashesCache.setCapacity(readCacheSize(srvInterface));
+        this->compressed = readCompressed(srvInterface);
+    }
+
+    virtual void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        LogTrace(traceLevel, TRACE_INFO, srvInterface, "sketch cache: %llu hits, %llu misses",
+                 (unsigned long long) (cache.getHits() + hashesCache.getHits()),
+                 (unsigned long long) (cache.getMisses() + hashesCache.getMisses()));
+    }
+};
+
+/**
+ * Factory of set operations over sketch arguments. The result is sized from the declared lengths of the input
+ * columns rather than from logK, as its hashes are a subset of theirs: by default of the hashes of all inputs.
+ */
 class ThetaSketchScalarFunctionFactory : public ScalarFunctionFactory {
     virtual void getReturnType(ServerInterface &srvfloaterface,
                                const SizedColumnTypes &inputTypes,
                                SizedColumnTypes &outputTypes) {
-        uint8_t logK = readLogK(srvfloaterface);
-        outputTypes.addLongVarbinary(quickSelectSketchMinSize(logK));
+        outputTypes.addLongVarbinary(compactSketchMaxSize(maxResultEntries(srvfloaterface, inputTypes)));
+    }
+
+protected:
+    virtual uint64_t maxResultEntries(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        uint64_t entries = 0;
+        for (size_t i = 0; i < inputTypes.getColumnCount(); i++) {
+            entries += sketchMaxEntries(inputTypes.getColumnType(i).getStringLength());
+        }
+        return entries;
     }
 
     virtual void getParameterType(ServerInterface &srvInterface,
                                   SizedColumnTypes &parameterTypes) {
-        // Unfortunately it cannot be forced in the intersection...
-        // So we have to trust the user to give the maximum logK used of the input sketches.
+        // Only used by the union, which otherwise derives it from its inputs.
         SizedColumnTypes::Properties logNominalProps;
         logNominalProps.required = false;
         logNominalProps.canBeNull = false;
         logNominalProps.comment = "Log Nominal value.";
         parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
 
-        SizedColumnTypes::Properties seedProps;
-        seedProps.required = false;
-        seedProps.canBeNull = false;
-        seedProps.comment = "Seed value";
-        parameterTypes.addInt(DATASKETCHES_SEED_PARAMETER_NAME, seedProps);
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
     }
 };
 
+/**
+ * Factory of aggregates serializing update sketches of the logK parameter, which hold up to about 15/16 of 2k hashes
+ * before they are rebuilt, hence sized with quickSelectSketchMaxSize rather than for k hashes.
+ */
 class ThetaSketchAggregateFunctionFactory : public AggregateFunctionFactory {
     virtual void getIntermediateTypes(ServerInterface &srvInterface,
                                       const SizedColumnTypes &inputTypes,
                                       SizedColumnTypes &intermediateTypeMetaData) {
         uint8_t logK = readLogK(srvInterface);
-        intermediateTypeMetaData.addVarbinary(quickSelectSketchMinSize(logK));
+        intermediateTypeMetaData.addLongVarbinary(quickSelectSketchMaxSize(logK));
     }
 
     virtual void getReturnType(ServerInterface &srvfloaterface,
                                const SizedColumnTypes &inputTypes,
                                SizedColumnTypes &outputTypes) {
         uint8_t logK = readLogK(srvfloaterface);
-        outputTypes.addVarbinary(quickSelectSketchMinSize(logK));
+        outputTypes.addLongVarbinary(quickSelectSketchMaxSize(logK));
     }
 
+protected:
     virtual void getParameterType(ServerInterface &srvInterface,
                                   SizedColumnTypes &parameterTypes) {
-        // Unfortunately it cannot be forced in the intersection...
-        // So we have to trust the user to give the maximum logK used of the input sketches.
         SizedColumnTypes::Properties logNominalProps;
         logNominalProps.required = false;
         logNominalProps.canBeNull = false;
         logNominalProps.comment = "Log Nominal value.";
         parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
 
-        SizedColumnTypes::Properties seedProps;
-        seedProps.required = false;
-        seedProps.canBeNull = false;
-        seedProps.comment = "Seed value";
-        parameterTypes.addInt(DATASKETCHES_SEED_PARAMETER_NAME, seedProps);
+        addSeedParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
     }
 };
 
@@ -82,11 +246,57 @@ class ThetaSketchAggregateFunction : public AggregateFunction {
 protected:
     uint8_t logK;
     uint64_t seed;
+    uint8_t traceLevel;
+    bool compressed;
+    std::unique_ptr<ordered_theta_merge> merge;
+    std::vector<char> combineBuffer;
+
+    /**
+     * Unions aggs with all of aggsOther into aggs. Intermediates are ordered compact sketches, so they are merged
+     * in place rather than deserialized and inserted one by one into a theta_union.
+     * The rows of aggsOther are all read before anything is written, their bytes have to stay valid until then.
+     */
+    void combineUnion(ServerInterface &srvInterface,
+                      IntermediateAggs &aggs,
+                      MultipleIntermediateAggs &aggsOther) {
+        // aggs is overwritten by the result, so it is merged from a copy.
+        const VString &current = aggs.getStringRef(0);
+        combineBuffer.assign(current.data(), current.data() + current.length());
+        merge->reset();
+        merge->add(combineBuffer.data(), combineBuffer.size());
+        do {
+            const VString &other = aggsOther.getStringRef(0);
+            merge->add(other.data(), other.length());
+        } while (aggsOther.next());
+
+        VString &result = aggs.getStringRef(0);
+        if (merge->canMerge()) {
+            result.alloc(merge->getMaxSerializedSize());
+            result.setLen(merge->serializeTo(result.data()));
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "theta combine: merged %zu sketches",
+                     merge->getInputs().size());
+            return;
+        }
+
+        LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "theta combine: union of %zu sketches",
+                 merge->getInputs().size());
+        auto u = theta_union_custom::builder()
+                .set_lg_k(logK)
+                .set_seed(seed)
+                .build();
+        for (auto &input: merge->getInputs()) {
+            u.update(deserializeThetaSketch(input.first, input.second, seed));
+        }
+        serializeThetaSketch(u.get_result(), result);
+    }
 
 public:
     virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
         this->logK = readLogK(srvInterface);
         this->seed = readSeed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->compressed = readCompressed(srvInterface);
+        this->merge.reset(new ordered_theta_merge(logK, seed));
     }
 
     virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
@@ -95,8 +305,7 @@ public:
                     .set_lg_k(logK)
                     .set_seed(seed)
                     .build();
-            auto data = u.get_result().serialize(); // provides compact & rebuild sketch <=> min size
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            serializeThetaSketch(u.get_result(), aggs.getStringRef(0)); // provides compact & rebuild sketch <=> min size
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
@@ -109,7 +318,12 @@ public:
         try {
             const VString &concat = aggs.getStringRef(0);
             VString &result = resWriter.getStringRef();
-            result.copy(&concat);
+            // Intermediates stay uncompressed for combine(), only the final sketch is compressed.
+            if (compressed) {
+                serializeThetaSketch(deserializeThetaSketch(concat.data(), concat.length(), seed), result, true);
+            } else {
+                result.copy(&concat);
+            }
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
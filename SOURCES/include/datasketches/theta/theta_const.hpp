@@ -1,12 +1,23 @@
 #ifndef VERTICA_UDFS_THETA_CONST_H
 #define VERTICA_UDFS_THETA_CONST_H
 
-#define DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME "logK"
+#include "../common_const.hpp"
+
 #define DATASKETCHES_LOG_NOMINAL_VALUE_DEFAULT 12
 #define DATASKETCHES_LOG_NOMINAL_VALUE_MIN 5
-// Vertica supports maximum 65000 bytes in a binary field, hence the limit.
-#define DATASKETCHES_LOG_NOMINAL_VALUE_MAX 32
-#define DATASKETCHES_SEED_PARAMETER_NAME "seed"
-#define DATASKETCHES_SEED_DEFAULT 9001
+// Largest logK of datasketches theta sketches.
+#define DATASKETCHES_LOG_NOMINAL_VALUE_MAX 26
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_THETA_MAX_SERIALIZED_SIZE 32000000
+#define DATASKETCHES_COMPRESSED_PARAMETER_NAME "compressed"
+#define DATASKETCHES_SAMPLING_PROBABILITY_PARAMETER_NAME "p"
+#define DATASKETCHES_SAMPLING_PROBABILITY_DEFAULT 1.0
+#define DATASKETCHES_LG_SHARDS_PARAMETER_NAME "lgShards"
+#define DATASKETCHES_LG_SHARDS_DEFAULT 4
+#define DATASKETCHES_LG_SHARDS_MAX 16
+#define DATASKETCHES_GRANULARITIES_PARAMETER_NAME "granularities"
+#define DATASKETCHES_GRANULARITIES_DEFAULT "day,week,month"
+// theta_sketch_cube emits 2^dimensions grouping sets.
+#define DATASKETCHES_CUBE_MAX_DIMENSIONS 12
 
 #endif //VERTICA_UDFS_THETA_CONST_H
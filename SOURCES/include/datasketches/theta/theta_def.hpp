@@ -4,12 +4,15 @@
 #include <theta_sketch.hpp>
 #include <theta_union.hpp>
 #include <theta_intersection.hpp>
+#include <theta_a_not_b.hpp>
 #include "../custom_alloc.hpp"
 
-typedef datasketches::update_theta_sketch_alloc <custom_alloc<int>> update_theta_sketch_custom;
-typedef datasketches::theta_intersection_alloc <custom_alloc<int>> theta_intersection_custom;
-typedef datasketches::theta_union_alloc <custom_alloc<int>> theta_union_custom;
-typedef datasketches::compact_theta_sketch_alloc <custom_alloc<int>> compact_theta_sketch_custom;
-typedef datasketches::theta_a_not_b_alloc<custom_alloc<int>> theta_a_not_b_custom;
+typedef datasketches::update_theta_sketch_alloc <custom_alloc<uint64_t>> update_theta_sketch_custom;
+typedef datasketches::theta_intersection_alloc <custom_alloc<uint64_t>> theta_intersection_custom;
+typedef datasketches::theta_union_alloc <custom_alloc<uint64_t>> theta_union_custom;
+typedef datasketches::compact_theta_sketch_alloc <custom_alloc<uint64_t>> compact_theta_sketch_custom;
+typedef datasketches::theta_a_not_b_alloc<custom_alloc<uint64_t>> theta_a_not_b_custom;
+// Hashes of a compact_theta_sketch_custom.
+typedef std::vector<uint64_t, custom_alloc<uint64_t>> theta_entries_custom;
 
 #endif //VERTICA_UDFS_THETA_DEF_HPP
@@ -0,0 +1,71 @@
+#ifndef VERTICA_UDFS_THETA_DIMENSIONS_HPP
+#define VERTICA_UDFS_THETA_DIMENSIONS_HPP
+
+#include <Vertica.h>
+#include <string>
+#include <vector>
+
+using namespace Vertica;
+
+/**
+ * Dimension columns of the transform functions grouping sketches by key (rollups, cubes). The values of a row
+ * are encoded one after the other into a byte string used as a hash key, and decoded back when writing results:
+ * a 1 byte tag, 0 for NULL, followed for non NULL values by 8 bytes for integers, or a 4 bytes length and the
+ * bytes for strings. Supports integer and character string columns.
+ */
+class DimensionColumns {
+public:
+    /**
+     * count dimensions, starting at column first of inputTypes. Reports an error on unsupported types.
+     */
+    DimensionColumns(const SizedColumnTypes &inputTypes, size_t first, size_t count);
+
+    size_t size() const {
+        return kinds.size();
+    }
+
+    /**
+     * Appends the encoded value of dimension i of the current row to key.
+     */
+    void read(PartitionReader &inputReader, size_t i, std::string &key) const;
+
+    /**
+     * Appends an encoded NULL to key.
+     */
+    static void appendNull(std::string &key);
+
+    /**
+     * Copies the encoded values of key to projected, keeping the dimensions i whose bit i is set in mask and
+     * replacing the others by NULL.
+     */
+    void project(const std::string &key, uint32_t mask, std::string &projected) const;
+
+    /**
+     * Writes the value of dimension i encoded at value to column of the output, and returns the end of the value.
+     */
+    const char *write(PartitionWriter &outputWriter, size_t i, size_t column, const char *value) const;
+
+    /**
+     * Same as the constructor for factories: reports an error on unsupported types, and adds the output columns
+     * of the dimensions, with their input names (dim1, dim2... for unnamed expressions).
+     */
+    static void addOutputTypes(const SizedColumnTypes &inputTypes, size_t first, size_t count,
+                               SizedColumnTypes &outputTypes);
+
+private:
+    enum Kind : uint8_t {
+        INT_DIMENSION, STRING_DIMENSION
+    };
+
+    size_t first;
+    std::vector<Kind> kinds;
+
+    /**
+     * End of the value of dimension i encoded at value.
+     */
+    const char *skip(size_t i, const char *value) const;
+
+    static Kind kindOf(const SizedColumnTypes &inputTypes, size_t column);
+};
+
+#endif //VERTICA_UDFS_THETA_DIMENSIONS_HPP
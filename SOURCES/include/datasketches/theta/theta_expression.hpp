@@ -0,0 +1,68 @@
+#ifndef VERTICA_UDFS_THETA_EXPRESSION_HPP
+#define VERTICA_UDFS_THETA_EXPRESSION_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "theta_set_ops.hpp"
+
+/**
+ * Set expression over sketches, e.g. '(a|b)&c-d': variables a to z stand for the inputs in order, '|' is the
+ * union, '&' the intersection and '-' the difference. '&' binds tighter than '|' and '-', which are left
+ * associative, so '(a|b)&c-d' is ((a|b)&c)-d.
+ *
+ * The expression is compiled once to postfix form and evaluated with the sorted array operations of
+ * theta_set_ops.hpp: intermediates stay in buffers reused from one evaluation to the next.
+ */
+class theta_expression {
+public:
+    /**
+     * Throws std::invalid_argument on a syntax error.
+     */
+    explicit theta_expression(const std::string &text);
+
+    const std::string &getText() const;
+
+    /**
+     * Number of inputs the expression reads, one more than its last variable.
+     */
+    size_t getNumInputs() const;
+
+    /**
+     * Evaluates the expression over inputs, which must hold getNumInputs() views. Unions keep at most k hashes,
+     * or all of them when k is 0. The result stays valid until the next evaluation.
+     */
+    const theta_hashes &evaluate(const std::vector<theta_hashes_view> &inputs, uint32_t k);
+
+private:
+    enum OpCode : uint8_t {
+        INPUT, UNION, INTERSECTION, A_NOT_B
+    };
+
+    struct Op {
+        OpCode code;
+        uint8_t input;
+    };
+
+    std::string text;
+    size_t numInputs;
+    std::vector<Op> program;
+    // Stack of operands, owned ones point into the buffer of the same depth.
+    std::vector<theta_hashes_view> stack;
+    std::vector<theta_hashes> buffers;
+    theta_hashes scratch;
+    // Copy of the input when the expression is a single variable.
+    theta_hashes result;
+
+    size_t parseExpression(size_t position);
+
+    size_t parseTerm(size_t position);
+
+    size_t parseFactor(size_t position);
+
+    size_t skipSpaces(size_t position) const;
+
+    [[noreturn]] void fail(size_t position, const char *message) const;
+};
+
+#endif //VERTICA_UDFS_THETA_EXPRESSION_HPP
@@ -0,0 +1,58 @@
+#ifndef VERTICA_UDFS_THETA_MERGE_HPP
+#define VERTICA_UDFS_THETA_MERGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Union of serialized ordered compact theta sketches (serial version 3) by a k-way merge of their sorted hashes.
+ *
+ * Inputs are read in place: their bytes must stay valid until serializeTo() returns. The result keeps the k smallest
+ * distinct hashes below the minimum theta of the non empty inputs, which is what theta_union produces, and is
+ * written ordered without going through a hash table.
+ * Inputs in any other format (unordered, compressed, other seed...) make canMerge() return false, in
+ * which case the caller falls back to theta_union over getInputs().
+ */
+class ordered_theta_merge {
+public:
+    ordered_theta_merge(uint8_t logK, uint64_t seed);
+
+    void reset();
+
+    void add(const char *data, size_t length);
+
+    bool canMerge() const;
+
+    const std::vector<std::pair<const char *, size_t>> &getInputs() const;
+
+    /**
+     * Upper bound of the serialized size of the union.
+     */
+    size_t getMaxSerializedSize() const;
+
+    /**
+     * Writes the union to out, which must hold getMaxSerializedSize() bytes, and returns its serialized size.
+     */
+    size_t serializeTo(char *out);
+
+private:
+    struct Run {
+        const char *next;
+        const char *end;
+    };
+
+    uint32_t k;
+    uint16_t seedHash;
+    bool mergeable;
+    bool empty;
+    uint64_t theta;
+    size_t maxEntries;
+    std::vector<std::pair<const char *, size_t>> inputs;
+    std::vector<Run> runs;
+    // Min heap of (hash, run index).
+    std::vector<std::pair<uint64_t, uint32_t>> heap;
+};
+
+#endif //VERTICA_UDFS_THETA_MERGE_HPP
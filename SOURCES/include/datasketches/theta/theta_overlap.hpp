@@ -0,0 +1,53 @@
+#ifndef VERTICA_UDFS_THETA_OVERLAP_HPP
+#define VERTICA_UDFS_THETA_OVERLAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "theta_set_ops.hpp"
+
+/**
+ * Pairwise intersections of a set of sketches, for overlap and Jaccard similarity matrices.
+ *
+ * Every pair is counted by a block merge of the sorted hashes of both sketches below their minimum theta,
+ * so each sketch is wrapped once rather than once per pair. Pairs are split in square tiles of TILE_SIZE
+ * sketches by TILE_SIZE sketches, whose hashes stay in cache while the tile is processed, and tiles are shared
+ * between worker threads.
+ */
+class theta_overlap {
+public:
+    static const size_t TILE_SIZE = 32;
+
+    explicit theta_overlap(const std::vector<theta_hashes> &sketches);
+
+    /**
+     * Counts the common hashes of all pairs, with numThreads threads (at least 1).
+     */
+    void compute(unsigned numThreads);
+
+    /**
+     * Estimated size of the intersection of sketches i and j, i < j.
+     */
+    double getIntersectionEstimate(size_t i, size_t j) const;
+
+    /**
+     * Estimated Jaccard similarity of sketches i and j, i < j: the common hashes over the hashes of either
+     * sketch below their minimum theta. 1 when neither has any.
+     */
+    double getJaccard(size_t i, size_t j) const;
+
+private:
+    const std::vector<theta_hashes> &sketches;
+    // Common hashes of every pair i < j, row by row.
+    std::vector<uint32_t> counts;
+
+    size_t pairIndex(size_t i, size_t j) const;
+
+    uint64_t pairTheta(size_t i, size_t j) const;
+
+    size_t countBelow(size_t i, uint64_t theta) const;
+
+    void computeTile(size_t tileRow, size_t tileColumn);
+};
+
+#endif //VERTICA_UDFS_THETA_OVERLAP_HPP
@@ -0,0 +1,29 @@
+#ifndef VERTICA_UDFS_THETA_ROLLUP_HPP
+#define VERTICA_UDFS_THETA_ROLLUP_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Time buckets of theta_sketch_rollup. Timestamps are Vertica TIMESTAMP values, microseconds since
+ * 2000-01-01 00:00:00, and buckets are computed on them as they are. Weeks start on Monday, as ISO weeks.
+ */
+enum rollup_granularity {
+    ROLLUP_HOUR, ROLLUP_DAY, ROLLUP_WEEK, ROLLUP_MONTH, ROLLUP_YEAR
+};
+
+/**
+ * Parses a comma separated list of granularity names, e.g. "day,week,month". Throws std::invalid_argument on
+ * unknown or repeated names.
+ */
+std::vector<rollup_granularity> parseRollupGranularities(const std::string &list);
+
+const char *rollupGranularityName(rollup_granularity granularity);
+
+/**
+ * Start of the bucket of the given granularity that contains timestamp.
+ */
+int64_t rollupBucketStart(int64_t timestamp, rollup_granularity granularity);
+
+#endif //VERTICA_UDFS_THETA_ROLLUP_HPP
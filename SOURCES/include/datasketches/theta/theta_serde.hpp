@@ -0,0 +1,266 @@
+#ifndef VERTICA_UDFS_THETA_SERDE_HPP
+#define VERTICA_UDFS_THETA_SERDE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "../seed_hash.hpp"
+
+/**
+ * Compact theta sketch format, serial version 3, as written by compact_theta_sketch::serialize().
+ * Preamble longs are 1 when empty or holding a single hash, 2 in exact mode, 3 in estimation mode.
+ *
+ * Compressed compact format, serial version 4, as written by compact_theta_sketch::serialize_compressed() in
+ * datasketches-cpp 4.0 and later: byte 3 holds the number of bits of every delta between consecutive sorted hashes,
+ * byte 4 the number of bytes of the entry count. The 8 bytes preamble is followed by theta in estimation mode
+ * (preamble longs 2), the little endian entry count, and the deltas packed most significant bit first by blocks
+ * of 8, each block taking exactly that number of bytes. Empty, unordered and exact single hash sketches are not
+ * compressed.
+ */
+namespace theta_serde {
+    const uint8_t SERIAL_VERSION = 3;
+    const uint8_t COMPRESSED_SERIAL_VERSION = 4;
+    const uint8_t COMPACT_SKETCH_TYPE = 3;
+    const uint8_t FLAG_BIG_ENDIAN = 1 << 0;
+    const uint8_t FLAG_READ_ONLY = 1 << 1;
+    const uint8_t FLAG_EMPTY = 1 << 2;
+    const uint8_t FLAG_COMPACT = 1 << 3;
+    const uint8_t FLAG_ORDERED = 1 << 4;
+    const uint64_t MAX_THETA = std::numeric_limits<int64_t>::max();
+    // Largest preamble, in bytes.
+    const size_t MAX_PREAMBLE_BYTES = 24;
+    // Narrowest entries written in the compressed format.
+    const uint8_t MIN_COMPRESSED_ENTRY_BITS = 16;
+
+    template<typename T>
+    inline T readAt(const char *data) {
+        T value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    template<typename T>
+    inline void writeAt(char *data, T value) {
+        std::memcpy(data, &value, sizeof(value));
+    }
+
+    inline uint8_t preambleLongs(bool empty, uint64_t theta, uint32_t numEntries) {
+        return !empty && theta < MAX_THETA ? 3 : (empty || numEntries == 1) ? 1 : 2;
+    }
+
+    /**
+     * Writes the preamble of an ordered compact sketch and returns its size.
+     */
+    inline size_t writePreamble(char *out, bool empty, uint16_t seedHash, uint64_t theta, uint32_t numEntries) {
+        const uint8_t longs = preambleLongs(empty, theta, numEntries);
+        std::memset(out, 0, longs * 8);
+        out[0] = longs;
+        out[1] = SERIAL_VERSION;
+        out[2] = COMPACT_SKETCH_TYPE;
+        out[5] = FLAG_READ_ONLY | FLAG_COMPACT | FLAG_ORDERED | (empty ? FLAG_EMPTY : 0);
+        writeAt(out + 6, seedHash);
+        if (longs > 1) {
+            writeAt(out + 8, numEntries);
+        }
+        if (longs > 2) {
+            writeAt(out + 16, theta);
+        }
+        return longs * 8;
+    }
+
+    inline bool isCompressed(const char *data, size_t length) {
+        return length > 1 && static_cast<uint8_t>(data[1]) == COMPRESSED_SERIAL_VERSION;
+    }
+
+    struct CompressedPreamble {
+        uint16_t seedHash;
+        uint64_t theta;
+        uint32_t numEntries;
+        uint8_t entryBits;
+        // Offset and size of the packed deltas.
+        size_t entriesOffset;
+        size_t entriesBytes;
+    };
+
+    /**
+     * Reads and checks the preamble of a compressed sketch, throws if malformed.
+     */
+    CompressedPreamble readCompressedPreamble(const char *data, size_t length);
+
+    /**
+     * Decodes the preamble.numEntries sorted hashes of a compressed sketch into entries.
+     */
+    void unpackCompressedEntries(const char *data, const CompressedPreamble &preamble, uint64_t *entries);
+
+    /**
+     * Writes values of bits bits each, most significant bit first.
+     */
+    class BitPacker {
+    public:
+        explicit BitPacker(char *out) : next(reinterpret_cast<uint8_t *>(out)), offset(0) {
+        }
+
+        void pack(uint64_t value, uint8_t bits) {
+            while (bits > 0) {
+                if (offset == 0) {
+                    *next = 0;
+                }
+                const uint8_t room = 8 - offset;
+                const uint8_t take = bits < room ? bits : room;
+                const uint8_t chunk = static_cast<uint8_t>(value >> (bits - take)) & ((1U << take) - 1);
+                *next |= chunk << (room - take);
+                offset += take;
+                bits -= take;
+                if (offset == 8) {
+                    next++;
+                    offset = 0;
+                }
+            }
+        }
+
+        char *end() const {
+            return reinterpret_cast<char *>(offset > 0 ? next + 1 : next);
+        }
+
+    private:
+        uint8_t *next;
+        uint8_t offset;
+    };
+
+    inline uint8_t compressedEntryCountBytes(uint32_t numEntries) {
+        uint8_t bytes = 0;
+        for (; numEntries > 0; numEntries >>= 8) {
+            bytes++;
+        }
+        return bytes;
+    }
+}
+
+/**
+ * Exact size of sketch serialized as a compact sketch. Works for update and compact sketches alike.
+ */
+template<typename Sketch>
+size_t compactThetaSerializedSize(const Sketch &sketch) {
+    const uint32_t numEntries = sketch.get_num_retained();
+    return theta_serde::preambleLongs(sketch.is_empty(), sketch.get_theta64(), numEntries) * 8
+           + static_cast<size_t>(numEntries) * 8;
+}
+
+/**
+ * Writes sketch as an ordered compact sketch to out, which must hold compactThetaSerializedSize(sketch) bytes,
+ * and returns the size written. This is the format of compact().serialize(), without the intermediate compact
+ * sketch and vector: hashes of unordered sketches are sorted in out directly.
+ */
+template<typename Sketch>
+size_t serializeCompactTheta(const Sketch &sketch, char *out) {
+    const uint32_t numEntries = sketch.get_num_retained();
+    char *entries = out + theta_serde::writePreamble(out, sketch.is_empty(), sketch.get_seed_hash(),
+                                                     sketch.get_theta64(), numEntries);
+    char *next = entries;
+    for (uint64_t hash: sketch) {
+        theta_serde::writeAt(next, hash);
+        next += sizeof(hash);
+    }
+    if (!sketch.is_ordered() && numEntries > 1) {
+        if (reinterpret_cast<uintptr_t>(entries) % alignof(uint64_t) == 0) {
+            uint64_t *hashes = reinterpret_cast<uint64_t *>(entries);
+            std::sort(hashes, hashes + numEntries);
+        } else {
+            std::vector<uint64_t> hashes(numEntries);
+            std::memcpy(hashes.data(), entries, numEntries * sizeof(uint64_t));
+            std::sort(hashes.begin(), hashes.end());
+            std::memcpy(entries, hashes.data(), numEntries * sizeof(uint64_t));
+        }
+    }
+    return next - out;
+}
+
+/**
+ * Bits needed by the largest delta between consecutive hashes of an ordered sketch.
+ */
+template<typename Sketch>
+uint8_t compressedEntryBits(const Sketch &sketch) {
+    uint64_t previous = 0;
+    uint64_t ored = 0;
+    for (uint64_t hash: sketch) {
+        ored |= hash - previous;
+        previous = hash;
+    }
+    uint8_t bits = 0;
+    for (; ored > 0; ored >>= 1) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * Same rules as compact_theta_sketch::serialize_compressed(), except that entries must take at least
+ * MIN_COMPRESSED_ENTRY_BITS: a compressed sketch then never holds more than 4 times the hashes of a compact
+ * sketch of the same size, which bounds the output of set operations. Deltas that small would take about
+ * 2^47 times k distinct values.
+ */
+template<typename Sketch>
+bool isSuitableForCompression(const Sketch &sketch) {
+    const uint32_t numEntries = sketch.get_num_retained();
+    return sketch.is_ordered() && !sketch.is_empty() && numEntries > 0
+           && (numEntries > 1 || sketch.get_theta64() < theta_serde::MAX_THETA)
+           && compressedEntryBits(sketch) >= theta_serde::MIN_COMPRESSED_ENTRY_BITS;
+}
+
+/**
+ * Exact size of sketch serialized in the compressed format, or in the compact format when not suitable.
+ */
+template<typename Sketch>
+size_t compressedThetaSerializedSize(const Sketch &sketch) {
+    if (!isSuitableForCompression(sketch)) {
+        return compactThetaSerializedSize(sketch);
+    }
+    const uint32_t numEntries = sketch.get_num_retained();
+    return (sketch.get_theta64() < theta_serde::MAX_THETA ? 16 : 8)
+           + theta_serde::compressedEntryCountBytes(numEntries)
+           + (static_cast<size_t>(numEntries) * compressedEntryBits(sketch) + 7) / 8;
+}
+
+/**
+ * Writes sketch in the compressed format to out, which must hold compressedThetaSerializedSize(sketch) bytes,
+ * and returns the size written. Falls back to serializeCompactTheta() when not suitable.
+ */
+template<typename Sketch>
+size_t serializeCompressedTheta(const Sketch &sketch, char *out) {
+    if (!isSuitableForCompression(sketch)) {
+        return serializeCompactTheta(sketch, out);
+    }
+    using namespace theta_serde;
+    const uint32_t numEntries = sketch.get_num_retained();
+    const uint64_t theta = sketch.get_theta64();
+    const uint8_t entryBits = compressedEntryBits(sketch);
+    const uint8_t entryCountBytes = compressedEntryCountBytes(numEntries);
+    out[0] = theta < MAX_THETA ? 2 : 1;
+    out[1] = COMPRESSED_SERIAL_VERSION;
+    out[2] = COMPACT_SKETCH_TYPE;
+    out[3] = entryBits;
+    out[4] = entryCountBytes;
+    out[5] = FLAG_READ_ONLY | FLAG_COMPACT | FLAG_ORDERED;
+    writeAt(out + 6, sketch.get_seed_hash());
+    char *next = out + 8;
+    if (theta < MAX_THETA) {
+        writeAt(next, theta);
+        next += 8;
+    }
+    for (uint8_t i = 0; i < entryCountBytes; i++) {
+        *next++ = static_cast<char>((numEntries >> (8 * i)) & 0xff);
+    }
+
+    BitPacker packer(next);
+    uint64_t previous = 0;
+    for (uint64_t hash: sketch) {
+        packer.pack(hash - previous, entryBits);
+        previous = hash;
+    }
+    return packer.end() - out;
+}
+
+#endif //VERTICA_UDFS_THETA_SERDE_HPP
@@ -0,0 +1,132 @@
+#ifndef VERTICA_UDFS_THETA_SET_OPS_HPP
+#define VERTICA_UDFS_THETA_SET_OPS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "theta_def.hpp"
+
+/**
+ * Hashes of a theta sketch as a sorted array, the form the set operations below work on. Sorting once when an
+ * input is wrapped turns every later union, intersection or difference into a linear merge.
+ */
+struct theta_hashes {
+    uint64_t theta;
+    bool empty;
+    theta_entries_custom entries;
+
+    theta_hashes();
+
+    explicit theta_hashes(const compact_theta_sketch_custom &sketch);
+
+    double getEstimate() const;
+
+    void swap(theta_hashes &other);
+};
+
+/**
+ * theta_hashes with the interface theta_serde.hpp serializes from, so that results are written out without
+ * first being copied into a compact_theta_sketch.
+ */
+class theta_hashes_sketch {
+public:
+    theta_hashes_sketch(const theta_hashes &hashes, uint16_t seedHash) : hashes(hashes), seedHash(seedHash) {
+    }
+
+    bool is_empty() const {
+        return hashes.empty;
+    }
+
+    bool is_ordered() const {
+        return true;
+    }
+
+    uint64_t get_theta64() const {
+        return hashes.theta;
+    }
+
+    uint32_t get_num_retained() const {
+        return static_cast<uint32_t>(hashes.entries.size());
+    }
+
+    uint16_t get_seed_hash() const {
+        return seedHash;
+    }
+
+    const uint64_t *begin() const {
+        return hashes.entries.data();
+    }
+
+    const uint64_t *end() const {
+        return hashes.entries.data() + hashes.entries.size();
+    }
+
+private:
+    const theta_hashes &hashes;
+    uint16_t seedHash;
+};
+
+/**
+ * Read only range of sorted hashes below theta: an input sketch or an intermediate result.
+ */
+struct theta_hashes_view {
+    uint64_t theta;
+    bool empty;
+    const uint64_t *begin;
+    const uint64_t *end;
+
+    theta_hashes_view() : theta(0), empty(true), begin(nullptr), end(nullptr) {
+    }
+
+    explicit theta_hashes_view(const theta_hashes &hashes)
+            : theta(hashes.theta), empty(hashes.empty),
+              begin(hashes.entries.data()), end(hashes.entries.data() + hashes.entries.size()) {
+    }
+
+    /**
+     * End of the hashes below the given theta.
+     */
+    const uint64_t *endBelow(uint64_t newTheta) const;
+};
+
+/**
+ * Set operations with the semantics of theta_union (without the k limit when k is 0), theta_intersection and
+ * theta_a_not_b. out must not be one of the inputs.
+ */
+void thetaUnion(const theta_hashes_view &a, const theta_hashes_view &b, uint32_t k, theta_hashes &out);
+
+void thetaIntersection(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out);
+
+void thetaANotB(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out);
+
+/**
+ * Hash of a value as update_theta_sketch computes it: the first 64 bits of its MurmurHash3_x64_128, shifted right
+ * by 1 bit. Never 0 in practice, 0 standing for values to ignore.
+ */
+uint64_t thetaHash(const void *data, size_t length, uint64_t seed);
+
+/**
+ * Sketch of precomputed theta hashes (see thetaHash()), with the content an update_theta_sketch of the same k
+ * would have once rebuilt: the k smallest distinct hashes. Hashes are buffered, and merged k at a time into the
+ * result once sorted.
+ */
+class theta_hash_builder {
+public:
+    explicit theta_hash_builder(uint32_t k);
+
+    void update(uint64_t hash);
+
+    const theta_hashes &getResult();
+
+    void reset();
+
+private:
+    uint32_t k;
+    theta_hashes result;
+    theta_hashes scratch;
+    std::vector<uint64_t> pending;
+
+    void flush();
+};
+
+#endif //VERTICA_UDFS_THETA_SET_OPS_HPP
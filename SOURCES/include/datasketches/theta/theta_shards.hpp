@@ -0,0 +1,42 @@
+#ifndef VERTICA_UDFS_THETA_SHARDS_HPP
+#define VERTICA_UDFS_THETA_SHARDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "theta_set_ops.hpp"
+
+/**
+ * Hash range sharding of theta sketches. Hashes are below 2^63, and shard i of 2^lgShards holds the hashes whose
+ * top lgShards bits (of 63) are i. A shard keeps the theta and empty flag of its sketch, so shards are regular
+ * theta sketches, and set operations commute with the split: the result of an operation is the concatenation of
+ * its results on every shard, cut to k for unions. This holds for stored shards as well, a union keeping at most
+ * k hashes per shard never dropping one of the k smallest hashes of the whole.
+ */
+uint32_t thetaShardOf(uint64_t hash, uint8_t lgShards);
+
+/**
+ * The hashes of a shard, as a range of the given hashes.
+ */
+theta_hashes_view thetaShard(const theta_hashes_view &hashes, uint32_t shard, uint8_t lgShards);
+
+/**
+ * Concatenates shards (or any sketches of the same seed) into out: the union of their hashes below their minimum
+ * theta, without the k limit of a union. Shards given in order are only copied.
+ */
+void thetaConcatenate(const std::vector<theta_hashes_view> &shards, theta_hashes &out);
+
+/**
+ * thetaUnion(), thetaIntersection() and thetaANotB() computed shard by shard on numThreads threads (at least 1),
+ * with the same results. Inputs are split in enough shards to balance threads, and small inputs are not split.
+ */
+void thetaShardedUnion(const theta_hashes_view &a, const theta_hashes_view &b, uint32_t k, theta_hashes &out,
+                       unsigned numThreads);
+
+void thetaShardedIntersection(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out,
+                              unsigned numThreads);
+
+void thetaShardedANotB(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out,
+                       unsigned numThreads);
+
+#endif //VERTICA_UDFS_THETA_SHARDS_HPP
@@ -0,0 +1,42 @@
+#ifndef VERTICA_UDFS_TRACE_HPP
+#define VERTICA_UDFS_TRACE_HPP
+
+#include <Vertica.h>
+#include <cstdint>
+
+using namespace Vertica;
+
+#define DATASKETCHES_TRACE_LEVEL_PARAMETER_NAME "traceLevel"
+#define DATASKETCHES_TRACE_LEVEL_ENV_VARIABLE "VERTICA_DATASKETCHES_TRACE_LEVEL"
+
+enum TraceLevel {
+    TRACE_OFF = 0,
+    TRACE_INFO = 1,
+    TRACE_DEBUG = 2,
+    TRACE_VERBOSE = 3
+};
+
+/**
+ * Trace level from the VERTICA_DATASKETCHES_TRACE_LEVEL environment variable, read once per process.
+ */
+uint8_t defaultTraceLevel();
+
+/**
+ * Trace level from the traceLevel parameter if provided, the environment default otherwise.
+ */
+uint8_t readTraceLevel(ServerInterface &serverInterface);
+
+void addTraceLevelParameter(SizedColumnTypes &parameterTypes);
+
+/**
+ * Logs to the UDx log when traceLevel is at least level. Arguments are not evaluated otherwise,
+ * hence traces may be left in hot paths.
+ */
+#define LogTrace(traceLevel, level, srvInterface, ...) \
+    do { \
+        if ((traceLevel) >= (level)) { \
+            (srvInterface).log(__VA_ARGS__); \
+        } \
+    } while (false)
+
+#endif //VERTICA_UDFS_TRACE_HPP
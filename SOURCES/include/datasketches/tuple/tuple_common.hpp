@@ -0,0 +1,204 @@
+#ifndef VERTICA_UDFS_TUPLE_COMMON_HPP
+#define VERTICA_UDFS_TUPLE_COMMON_HPP
+
+#include <Vertica.h>
+#include <cstdint>
+#include "tuple_const.hpp"
+#include "tuple_def.hpp"
+#include "../common.hpp"
+#include "../serialize.hpp"
+#include "../trace.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+uint8_t readTupleLogK(ServerInterface &serverInterface);
+
+double_summary_policy::mode readTupleMode(ServerInterface &serverInterface);
+
+void addTupleModeParameter(SizedColumnTypes &parameterTypes);
+
+/**
+ * Upper bound of a serialized tuple sketch of the given logK: an update sketch holds up to 2^(logK+1) entries of
+ * a 64 bits hash and a double summary.
+ */
+uint32_t tupleSketchMaxSize(uint8_t logK);
+
+/**
+ * Serializes sketch straight into out.
+ */
+inline void serializeTupleSketch(const compact_tuple_sketch_custom &sketch, VString &out) {
+    const size_t size = 24 + static_cast<size_t>(sketch.get_num_retained()) * (sizeof(uint64_t) + sizeof(double));
+    serializeToVString(out, size, [&sketch](std::ostream &os) {
+        sketch.serialize(os);
+    });
+}
+
+inline compact_tuple_sketch_custom deserializeTupleSketch(const char *data, size_t length, uint64_t seed) {
+    return compact_tuple_sketch_custom::deserialize(data, length, seed);
+}
+
+/**
+ * Keys policies read the key from the first argument column and its value from the second one into the sketch.
+ * Rows with a NULL key or value, or an empty VARCHAR key, are skipped.
+ */
+struct TupleVarcharKeys {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addVarchar();
+    }
+
+    void update(update_tuple_sketch_custom &sketch, BlockReader &argReader) {
+        const VString &key = argReader.getStringRef(0);
+        const vfloat value = argReader.getFloatRef(1);
+        // The raw data update hashes empty keys, update_tuple_sketch only ignores empty std::string keys.
+        if (key.isNull() || key.length() == 0 || vfloatIsNull(value)) {
+            return;
+        }
+        sketch.update(key.data(), key.length(), value);
+    }
+};
+
+struct TupleIntKeys {
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addInt();
+    }
+
+    void update(update_tuple_sketch_custom &sketch, BlockReader &argReader) {
+        const vint key = argReader.getIntRef(0);
+        const vfloat value = argReader.getFloatRef(1);
+        if (key == vint_null || vfloatIsNull(value)) {
+            return;
+        }
+        sketch.update(static_cast<int64_t>(key), value);
+    }
+};
+
+/**
+ * Scalar function reading serialized sketches through a per instance cache, as theta scalar functions do.
+ */
+class TupleSketchScalarFunction : public ScalarFunction {
+protected:
+    uint64_t seed;
+    uint8_t traceLevel;
+    SketchCache<compact_tuple_sketch_custom> cache;
+
+    SketchCache<compact_tuple_sketch_custom>::sketch_ptr getSketch(const VString &bytes) {
+        uint64_t sketchSeed = seed;
+        return cache.get(bytes.data(), bytes.length(), [sketchSeed](const char *data, size_t length) {
+            return deserializeTupleSketch(data, length, sketchSeed);
+        });
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->seed = readSeed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->cache.setCapacity(readCacheSize(srvInterface));
+    }
+
+    virtual void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        LogTrace(traceLevel, TRACE_INFO, srvInterface, "sketch cache: %llu hits, %llu misses",
+                 (unsigned long long) cache.getHits(), (unsigned long long) cache.getMisses());
+    }
+};
+
+class TupleSketchAggregateFunctionFactory : public AggregateFunctionFactory {
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        uint8_t logK = readTupleLogK(srvInterface);
+        intermediateTypeMetaData.addLongVarbinary(tupleSketchMaxSize(logK));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        uint8_t logK = readTupleLogK(srvfloaterface);
+        outputTypes.addLongVarbinary(tupleSketchMaxSize(logK));
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addSeedParameter(parameterTypes);
+        addTupleModeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+/**
+ * Base of tuple sketch aggregates: intermediates are compact tuple sketches, combined with a tuple_union
+ * applying the summary mode of the query.
+ */
+class TupleSketchAggregateFunction : public AggregateFunction {
+protected:
+    uint8_t logK;
+    uint64_t seed;
+    double_summary_policy policy;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->logK = readTupleLogK(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->policy = double_summary_policy(readTupleMode(srvInterface));
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            auto u = tuple_union_custom::builder(policy)
+                    .set_lg_k(logK)
+                    .set_seed(seed)
+                    .build();
+            serializeTupleSketch(u.get_result(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            auto u = tuple_union_custom::builder(policy)
+                    .set_lg_k(logK)
+                    .set_seed(seed)
+                    .build();
+            u.update(deserializeTupleSketch(aggs.getStringRef(0).data(), aggs.getStringRef(0).length(), seed));
+            int merged = 0;
+            do {
+                u.update(deserializeTupleSketch(aggsOther.getStringRef(0).data(),
+                                                aggsOther.getStringRef(0).length(), seed));
+                merged++;
+            } while (aggsOther.next());
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "tuple combine: merged %d sketches", merged);
+
+            serializeTupleSketch(u.get_result(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void terminate(ServerInterface &srvInterface,
+                           BlockWriter &resWriter,
+                           IntermediateAggs &aggs) override {
+        try {
+            const VString &concat = aggs.getStringRef(0);
+            VString &result = resWriter.getStringRef();
+            result.copy(&concat);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
+        }
+    }
+};
+
+#endif //VERTICA_UDFS_TUPLE_COMMON_HPP
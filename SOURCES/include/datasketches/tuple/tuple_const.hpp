@@ -0,0 +1,13 @@
+#ifndef VERTICA_UDFS_TUPLE_CONST_H
+#define VERTICA_UDFS_TUPLE_CONST_H
+
+// Tuple sketches take the logK bounds of theta sketches.
+#define DATASKETCHES_TUPLE_LOG_K_DEFAULT 12
+#define DATASKETCHES_TUPLE_LOG_K_MIN 5
+#define DATASKETCHES_TUPLE_LOG_K_MAX 26
+#define DATASKETCHES_TUPLE_MODE_PARAMETER_NAME "mode"
+#define DATASKETCHES_TUPLE_STATISTIC_PARAMETER_NAME "statistic"
+// Vertica supports maximum 32000000 bytes in a LONG VARBINARY field.
+#define DATASKETCHES_TUPLE_MAX_SERIALIZED_SIZE 32000000
+
+#endif //VERTICA_UDFS_TUPLE_CONST_H
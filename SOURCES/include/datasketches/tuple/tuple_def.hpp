@@ -0,0 +1,61 @@
+#ifndef VERTICA_UDFS_TUPLE_DEF_HPP
+#define VERTICA_UDFS_TUPLE_DEF_HPP
+
+#include <limits>
+#include <tuple_sketch.hpp>
+#include <tuple_union.hpp>
+#include <tuple_intersection.hpp>
+#include "../custom_alloc.hpp"
+
+/**
+ * Policy of double summaries, chosen at runtime: the values of a key are summed, or only their min or max is kept.
+ * It serves as update, union and intersection policy, so a single mode applies to a whole query and should be
+ * the one the stored sketches were built with.
+ */
+class double_summary_policy {
+public:
+    enum mode {
+        SUM, MIN, MAX
+    };
+
+    explicit double_summary_policy(mode m = SUM) : m(m) {
+    }
+
+    double create() const {
+        switch (m) {
+            case MIN:
+                return std::numeric_limits<double>::infinity();
+            case MAX:
+                return -std::numeric_limits<double>::infinity();
+            default:
+                return 0;
+        }
+    }
+
+    void update(double &summary, double value) const {
+        switch (m) {
+            case MIN:
+                summary = value < summary ? value : summary;
+                break;
+            case MAX:
+                summary = value > summary ? value : summary;
+                break;
+            default:
+                summary += value;
+        }
+    }
+
+    void operator()(double &summary, const double &other) const {
+        update(summary, other);
+    }
+
+private:
+    mode m;
+};
+
+typedef datasketches::update_tuple_sketch<double, double, double_summary_policy, custom_alloc<double>> update_tuple_sketch_custom;
+typedef datasketches::compact_tuple_sketch<double, custom_alloc<double>> compact_tuple_sketch_custom;
+typedef datasketches::tuple_union<double, double_summary_policy, custom_alloc<double>> tuple_union_custom;
+typedef datasketches::tuple_intersection<double, double_summary_policy, custom_alloc<double>> tuple_intersection_custom;
+
+#endif //VERTICA_UDFS_TUPLE_DEF_HPP
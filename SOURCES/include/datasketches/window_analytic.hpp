@@ -0,0 +1,78 @@
+#ifndef VERTICA_UDFS_WINDOW_ANALYTIC_HPP
+#define VERTICA_UDFS_WINDOW_ANALYTIC_HPP
+
+#include <Vertica.h>
+#include "sliding_window.hpp"
+#include "trace.hpp"
+#include "common.hpp"
+
+using namespace Vertica;
+
+/**
+ * Analytic function returning, for every row, the union of the last `window` panes of its partition, a pane being
+ * the rows sharing an ORDER BY value. Every pane is sketched once and the unions are maintained by a
+ * two_stack_window, so a partition costs a number of unions linear in its number of panes, whatever the window.
+ * Vertica does not pass window frames to analytic UDx, hence the window parameter.
+ *
+ * Window provides the two_stack_window operations, plus:
+ * - setup(ServerInterface &)
+ * - void add(AnalyticPartitionReader &) adding the current row to the pane being built
+ * - value_type takePane() returning that pane and starting a new one
+ * - void write(AnalyticPartitionWriter &, const value_type &) setting the result of a row
+ */
+template<class Window>
+class SlidingWindowAnalytic : public AnalyticFunction {
+protected:
+    Window policy;
+    size_t window;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->policy.setup(srvInterface);
+        this->window = readWindow(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  AnalyticPartitionReader &inputReader,
+                                  AnalyticPartitionWriter &outputWriter) {
+        try {
+            two_stack_window<Window> panes(policy);
+            size_t paneRows = 0;
+            size_t numPanes = 0;
+            do {
+                if (inputReader.isNewOrderByKey() && paneRows > 0) {
+                    closePane(panes, paneRows, outputWriter);
+                    numPanes++;
+                    paneRows = 0;
+                }
+                policy.add(inputReader);
+                paneRows++;
+            } while (inputReader.next() && !isCanceled());
+            if (paneRows > 0) {
+                closePane(panes, paneRows, outputWriter);
+                numPanes++;
+            }
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "sliding window: %zu panes", numPanes);
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+
+private:
+    void closePane(two_stack_window<Window> &panes, size_t paneRows, AnalyticPartitionWriter &outputWriter) {
+        panes.push(policy.takePane());
+        if (panes.size() > window) {
+            panes.pop();
+        }
+        const typename Window::value_type result = panes.query();
+        for (size_t i = 0; i < paneRows; i++) {
+            policy.write(outputWriter, result);
+            outputWriter.next();
+        }
+    }
+};
+
+#endif //VERTICA_UDFS_WINDOW_ANALYTIC_HPP
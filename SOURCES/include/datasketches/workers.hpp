@@ -0,0 +1,14 @@
+#ifndef VERTICA_UDFS_WORKERS_HPP
+#define VERTICA_UDFS_WORKERS_HPP
+
+#include <functional>
+
+/**
+ * Runs worker on the calling thread and on numThreads - 1 std::thread, which must share their work (e.g. through
+ * an atomic counter). Exceptions of the workers, or of a thread that cannot be started, do not reach
+ * std::terminate: the first one is kept, all started threads are joined, and it is rethrown on the calling thread,
+ * where functions report it with vt_report_error.
+ */
+void runWorkers(unsigned numThreads, const std::function<void()> &worker);
+
+#endif //VERTICA_UDFS_WORKERS_HPP
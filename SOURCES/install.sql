@@ -41,14 +41,14 @@ CREATE OR REPLACE AGGREGATE FUNCTION theta_sketch_union_agg AS
 GRANT EXECUTE ON AGGREGATE FUNCTION theta_sketch_union_agg(LONG VARBINARY) TO PUBLIC;
 
 -- SELECT key, theta_sketch_create(varchar) FROM ... GROUP BY key
--- returns sketch data as varbinary
+-- returns sketch data as long varbinary
 CREATE OR REPLACE AGGREGATE FUNCTION theta_sketch_create AS
     LANGUAGE 'C++'
     NAME 'ThetaSketchAggregateCreateVarcharFactory' LIBRARY DataSketches;
 GRANT EXECUTE ON AGGREGATE FUNCTION theta_sketch_create(VARCHAR) TO PUBLIC;
 
 -- SELECT key, theta_sketch_create(binary) FROM ... GROUP BY key
--- returns sketch data as varbinary
+-- returns sketch data as long varbinary
 CREATE OR REPLACE AGGREGATE FUNCTION theta_sketch_create AS
     LANGUAGE 'C++'
     NAME 'ThetaSketchAggregateCreateVarbinaryFactory' LIBRARY DataSketches;
@@ -72,6 +72,107 @@ CREATE OR REPLACE FUNCTION theta_sketch_a_not_b AS
     NAME 'ThetaSketchANotBFactory' LIBRARY DataSketches;
 GRANT EXECUTE ON FUNCTION theta_sketch_a_not_b(LONG VARBINARY, LONG VARBINARY) TO PUBLIC;
 
+-- SELECT theta_sketch_compress(theta_sketch) FROM ...
+-- returns the sketch in the compressed format, readable by every theta function
+CREATE OR REPLACE FUNCTION theta_sketch_compress AS
+    LANGUAGE 'C++'
+    NAME 'ThetaSketchCompressFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION theta_sketch_compress(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT theta_sketch_eval('(a|b)&c-d', sketch_a, sketch_b, sketch_c, sketch_d) FROM ...
+-- evaluates a set expression over its sketch arguments: | union, & intersection, - difference
+CREATE OR REPLACE FUNCTION theta_sketch_eval AS
+    LANGUAGE 'C++'
+    NAME 'ThetaSketchEvalFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION theta_sketch_eval(VARCHAR) TO PUBLIC;
+
+-- SELECT theta_sketch_eval_estimate('(a|b)&c-d', sketch_a, sketch_b, sketch_c, sketch_d) FROM ...
+CREATE OR REPLACE FUNCTION theta_sketch_eval_estimate AS
+    LANGUAGE 'C++'
+    NAME 'ThetaSketchEvalEstimateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION theta_sketch_eval_estimate(VARCHAR) TO PUBLIC;
+
+-- SELECT theta_sketch_overlap_matrix(segment_id, theta_sketch) OVER () FROM ...
+-- returns (i, j, intersection, jaccard) for every pair of segments
+CREATE OR REPLACE TRANSFORM FUNCTION theta_sketch_overlap_matrix AS
+    LANGUAGE 'C++'
+    NAME 'ThetaOverlapMatrixUDTFFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION theta_sketch_overlap_matrix(INTEGER, LONG VARBINARY) TO PUBLIC;
+
+-- SELECT theta_sketch_create_distributed(varchar) OVER (PARTITION AUTO) FROM ...
+-- sketches every local segment in a prepass, then unions these sketches on a single node
+CREATE OR REPLACE TRANSFORM FUNCTION theta_sketch_create_distributed AS
+    LANGUAGE 'C++'
+    NAME 'ThetaCreateMultiPhaseFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION theta_sketch_create_distributed(VARCHAR) TO PUBLIC;
+
+-- SELECT theta_sketch_window_union(theta_sketch USING PARAMETERS window=7) OVER (PARTITION BY ... ORDER BY day) FROM ...
+-- returns the union of the sketches of the last 7 ORDER BY values, for every row
+CREATE OR REPLACE ANALYTIC FUNCTION theta_sketch_window_union AS
+    LANGUAGE 'C++'
+    NAME 'ThetaWindowUnionFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON ANALYTIC FUNCTION theta_sketch_window_union(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT theta_sketch_window_estimate(varchar USING PARAMETERS window=7) OVER (PARTITION BY ... ORDER BY day) FROM ...
+-- returns the distinct count estimate of the last 7 ORDER BY values, for every row
+CREATE OR REPLACE ANALYTIC FUNCTION theta_sketch_window_estimate AS
+    LANGUAGE 'C++'
+    NAME 'ThetaWindowEstimateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON ANALYTIC FUNCTION theta_sketch_window_estimate(VARCHAR) TO PUBLIC;
+
+-- SELECT theta_sketch_rollup(time, dims..., theta_sketch) OVER (PARTITION BY ... ORDER BY time) FROM ...
+-- returns (granularity, bucket, dims..., sketch) rows, one per day, week and month bucket and dimension values
+CREATE OR REPLACE TRANSFORM FUNCTION theta_sketch_rollup AS
+    LANGUAGE 'C++'
+    NAME 'ThetaRollupUDTFFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION theta_sketch_rollup(ANY) TO PUBLIC;
+
+-- SELECT theta_sketch_cube(dims..., varchar) OVER (PARTITION BY ...) FROM ...
+-- returns (grouping_id, dims..., sketch) rows for every grouping set of the dimensions
+CREATE OR REPLACE TRANSFORM FUNCTION theta_sketch_cube AS
+    LANGUAGE 'C++'
+    NAME 'ThetaCubeUDTFFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION theta_sketch_cube(ANY) TO PUBLIC;
+
+-- SELECT key, theta_sketch_update(base_sketch, varchar) FROM ... GROUP BY key
+-- returns base_sketch with the values of the group added, as long varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION theta_sketch_update AS
+    LANGUAGE 'C++'
+    NAME 'ThetaSketchAggregateUpdateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION theta_sketch_update(LONG VARBINARY, VARCHAR) TO PUBLIC;
+
+-- SELECT theta_hash(varchar) FROM ...
+-- returns the hash theta sketches compute for the value, as integer
+CREATE OR REPLACE FUNCTION theta_hash AS
+    LANGUAGE 'C++'
+    NAME 'ThetaHashVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION theta_hash(VARCHAR) TO PUBLIC;
+CREATE OR REPLACE FUNCTION theta_hash AS
+    LANGUAGE 'C++'
+    NAME 'ThetaHashVarbinaryFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION theta_hash(VARBINARY) TO PUBLIC;
+
+-- SELECT key, theta_sketch_create_from_hash(theta_hash) FROM ... GROUP BY key
+-- returns sketch data as long varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION theta_sketch_create_from_hash AS
+    LANGUAGE 'C++'
+    NAME 'ThetaSketchAggregateCreateFromHashFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION theta_sketch_create_from_hash(INTEGER) TO PUBLIC;
+
+-- SELECT s.key, n.shard, theta_sketch_shard(s.sketch, n.shard USING PARAMETERS lgShards=4) FROM sketches s, shard_numbers n
+-- returns the hashes of the sketch in hash range shard n.shard, as long varbinary
+CREATE OR REPLACE FUNCTION theta_sketch_shard AS
+    LANGUAGE 'C++'
+    NAME 'ThetaSketchShardFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION theta_sketch_shard(LONG VARBINARY, INTEGER) TO PUBLIC;
+
+-- SELECT key, theta_sketch_unshard(shard_sketch USING PARAMETERS lgShards=4) FROM ... GROUP BY key
+-- returns the concatenation of the shards as long varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION theta_sketch_unshard AS
+    LANGUAGE 'C++'
+    NAME 'ThetaSketchAggregateUnshardFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION theta_sketch_unshard(LONG VARBINARY) TO PUBLIC;
+
 -- Frequency sketches
 -- SELECT key, frequency_sketch_create(varchar) FROM ... GROUP BY key
 -- Returns JSON array of [key,frequency] pairs
@@ -80,6 +181,92 @@ CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_create AS
     NAME 'FrequencyAggregateCreateFactory' LIBRARY DataSketches;
 GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_create(VARCHAR) TO PUBLIC;
 
+-- SELECT key, frequency_sketch_create(integer) FROM ... GROUP BY key
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateCreateIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_create(INTEGER) TO PUBLIC;
+
+-- SELECT key, frequency_sketch_create(uuid) FROM ... GROUP BY key
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateCreateUuidFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_create(UUID) TO PUBLIC;
+
+-- SELECT key, frequency_sketch_create(item, weight) FROM ... GROUP BY key
+-- weighted variant for pre-aggregated (item, count) rows, item being varchar, integer or uuid
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateCreateWeightedFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_create(VARCHAR, INTEGER) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateCreateWeightedIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_create(INTEGER, INTEGER) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateCreateWeightedUuidFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_create(UUID, INTEGER) TO PUBLIC;
+
+-- SELECT key, frequency_sketch_build(varchar|integer|uuid [, weight]) FROM ... GROUP BY key
+-- returns sketch data as varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_build AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateBuildVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_build(VARCHAR) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_build AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateBuildIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_build(INTEGER) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_build AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateBuildUuidFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_build(UUID) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_build AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateBuildWeightedVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_build(VARCHAR, INTEGER) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_build AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateBuildWeightedIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_build(INTEGER, INTEGER) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_build AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateBuildWeightedUuidFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_build(UUID, INTEGER) TO PUBLIC;
+
+-- SELECT key, frequency_sketch_union_agg(frequency_sketch) FROM ... GROUP BY key
+-- The _int and _uuid variants merge sketches built from INTEGER and UUID items.
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_union_agg AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateUnionVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_union_agg(LONG VARBINARY) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_union_agg_int AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateUnionIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_union_agg_int(LONG VARBINARY) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION frequency_sketch_union_agg_uuid AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyAggregateUnionUuidFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION frequency_sketch_union_agg_uuid(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT key, frequency_sketch_get_items(frequency_sketch USING PARAMETERS errorType='NO_FALSE_NEGATIVES', limit=10)
+--     OVER (PARTITION BY key) FROM ...
+-- returns one (item, estimate, lower_bound, upper_bound) row per frequent item
+-- The _int and _uuid variants read sketches built from INTEGER and UUID items.
+CREATE OR REPLACE TRANSFORM FUNCTION frequency_sketch_get_items AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyGetItemsVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION frequency_sketch_get_items(LONG VARBINARY) TO PUBLIC;
+CREATE OR REPLACE TRANSFORM FUNCTION frequency_sketch_get_items_int AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyGetItemsIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION frequency_sketch_get_items_int(LONG VARBINARY) TO PUBLIC;
+CREATE OR REPLACE TRANSFORM FUNCTION frequency_sketch_get_items_uuid AS
+    LANGUAGE 'C++'
+    NAME 'FrequencyGetItemsUuidFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION frequency_sketch_get_items_uuid(LONG VARBINARY) TO PUBLIC;
+
 -- HLL sketches
 -- SELECT key, frequency_sketch_create(varchar) FROM ... GROUP BY key
 -- returns cardinality estimate as integer
@@ -88,3 +275,229 @@ CREATE OR REPLACE AGGREGATE FUNCTION hll_sketch_create AS
     NAME 'HllAggregateCreateFactory' LIBRARY DataSketches;
 GRANT EXECUTE ON AGGREGATE FUNCTION hll_sketch_create(VARCHAR) TO PUBLIC;
 
+
+-- SELECT key, hll_sketch_create_from_hash(theta_hash) FROM ... GROUP BY key
+-- returns cardinality estimate as integer
+CREATE OR REPLACE AGGREGATE FUNCTION hll_sketch_create_from_hash AS
+    LANGUAGE 'C++'
+    NAME 'HllAggregateCreateFromHashFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION hll_sketch_create_from_hash(INTEGER) TO PUBLIC;
+
+-- SELECT hll_map_distinct(key, value) OVER (PARTITION BY key_bucket) FROM ...
+-- returns one (key, estimate) row per key, key and value being varchar or integer
+CREATE OR REPLACE TRANSFORM FUNCTION hll_map_distinct AS
+    LANGUAGE 'C++'
+    NAME 'HllMapVarcharVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION hll_map_distinct(VARCHAR, VARCHAR) TO PUBLIC;
+CREATE OR REPLACE TRANSFORM FUNCTION hll_map_distinct AS
+    LANGUAGE 'C++'
+    NAME 'HllMapVarcharIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION hll_map_distinct(VARCHAR, INTEGER) TO PUBLIC;
+CREATE OR REPLACE TRANSFORM FUNCTION hll_map_distinct AS
+    LANGUAGE 'C++'
+    NAME 'HllMapIntVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION hll_map_distinct(INTEGER, VARCHAR) TO PUBLIC;
+CREATE OR REPLACE TRANSFORM FUNCTION hll_map_distinct AS
+    LANGUAGE 'C++'
+    NAME 'HllMapIntIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON TRANSFORM FUNCTION hll_map_distinct(INTEGER, INTEGER) TO PUBLIC;
+
+-- SELECT hll_sketch_window_estimate(varchar USING PARAMETERS window=7) OVER (PARTITION BY ... ORDER BY day) FROM ...
+-- returns the distinct count estimate of the last 7 ORDER BY values as integer, for every row
+CREATE OR REPLACE ANALYTIC FUNCTION hll_sketch_window_estimate AS
+    LANGUAGE 'C++'
+    NAME 'HllWindowEstimateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON ANALYTIC FUNCTION hll_sketch_window_estimate(VARCHAR) TO PUBLIC;
+
+-- SELECT key, hll_sketch_update(base_sketch, varchar) FROM ... GROUP BY key
+-- returns base_sketch with the values of the group added, as long varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION hll_sketch_update AS
+    LANGUAGE 'C++'
+    NAME 'HllAggregateUpdateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION hll_sketch_update(LONG VARBINARY, VARCHAR) TO PUBLIC;
+
+-- SELECT hll_sketch_get_estimate(hll_sketch) FROM ...
+-- returns cardinality estimate as integer
+CREATE OR REPLACE FUNCTION hll_sketch_get_estimate AS
+    LANGUAGE 'C++'
+    NAME 'HllSketchGetEstimateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION hll_sketch_get_estimate(LONG VARBINARY) TO PUBLIC;
+
+-- cpc sketches
+-- SELECT key, cpc_sketch_create(value) FROM ... GROUP BY key
+-- returns sketch data as long varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION cpc_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'CpcAggregateCreateVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION cpc_sketch_create(VARCHAR) TO PUBLIC;
+
+CREATE OR REPLACE AGGREGATE FUNCTION cpc_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'CpcAggregateCreateIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION cpc_sketch_create(INTEGER) TO PUBLIC;
+
+CREATE OR REPLACE AGGREGATE FUNCTION cpc_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'CpcAggregateCreateVarbinaryFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION cpc_sketch_create(VARBINARY) TO PUBLIC;
+
+-- SELECT key, cpc_sketch_union_agg(cpc_sketch) FROM ... GROUP BY key
+CREATE OR REPLACE AGGREGATE FUNCTION cpc_sketch_union_agg AS
+    LANGUAGE 'C++'
+    NAME 'CpcAggregateUnionFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION cpc_sketch_union_agg(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT cpc_sketch_get_estimate(cpc_sketch) FROM ...
+CREATE OR REPLACE FUNCTION cpc_sketch_get_estimate AS
+    LANGUAGE 'C++'
+    NAME 'CpcSketchGetEstimateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION cpc_sketch_get_estimate(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT cpc_sketch_get_lower_bound(cpc_sketch, kappa) FROM ...
+CREATE OR REPLACE FUNCTION cpc_sketch_get_lower_bound AS
+    LANGUAGE 'C++'
+    NAME 'CpcSketchGetLBoundFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION cpc_sketch_get_lower_bound(LONG VARBINARY, INTEGER) TO PUBLIC;
+
+-- SELECT cpc_sketch_get_upper_bound(cpc_sketch, kappa) FROM ...
+CREATE OR REPLACE FUNCTION cpc_sketch_get_upper_bound AS
+    LANGUAGE 'C++'
+    NAME 'CpcSketchGetUBoundFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION cpc_sketch_get_upper_bound(LONG VARBINARY, INTEGER) TO PUBLIC;
+
+-- tuple sketches
+-- SELECT tuple_sketch_create(key, value USING PARAMETERS mode='sum') FROM ...
+-- returns sketch data as long varbinary, mode is sum (default), min or max
+CREATE OR REPLACE AGGREGATE FUNCTION tuple_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'TupleAggregateCreateVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION tuple_sketch_create(VARCHAR, FLOAT) TO PUBLIC;
+
+CREATE OR REPLACE AGGREGATE FUNCTION tuple_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'TupleAggregateCreateIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION tuple_sketch_create(INTEGER, FLOAT) TO PUBLIC;
+
+-- SELECT tuple_sketch_union_agg(tuple_sketch USING PARAMETERS mode='sum') FROM ...
+CREATE OR REPLACE AGGREGATE FUNCTION tuple_sketch_union_agg AS
+    LANGUAGE 'C++'
+    NAME 'TupleAggregateUnionFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION tuple_sketch_union_agg(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT tuple_sketch_intersection_agg(tuple_sketch USING PARAMETERS mode='sum') FROM ...
+CREATE OR REPLACE AGGREGATE FUNCTION tuple_sketch_intersection_agg AS
+    LANGUAGE 'C++'
+    NAME 'TupleAggregateIntersectionFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION tuple_sketch_intersection_agg(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT tuple_sketch_get_estimate(tuple_sketch) FROM ...
+CREATE OR REPLACE FUNCTION tuple_sketch_get_estimate AS
+    LANGUAGE 'C++'
+    NAME 'TupleSketchGetEstimateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION tuple_sketch_get_estimate(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT tuple_sketch_get_summary(tuple_sketch USING PARAMETERS statistic='sum') FROM ...
+-- statistic is sum (default), mean, min or max
+CREATE OR REPLACE FUNCTION tuple_sketch_get_summary AS
+    LANGUAGE 'C++'
+    NAME 'TupleSketchGetSummaryFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION tuple_sketch_get_summary(LONG VARBINARY) TO PUBLIC;
+
+-- kll sketches
+-- SELECT kll_sketch_create(value USING PARAMETERS k=200) FROM ...
+-- returns sketch data as long varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION kll_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'KllAggregateCreateFloatFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION kll_sketch_create(FLOAT) TO PUBLIC;
+
+CREATE OR REPLACE AGGREGATE FUNCTION kll_sketch_create AS
+    LANGUAGE 'C++'
+    NAME 'KllAggregateCreateIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION kll_sketch_create(INTEGER) TO PUBLIC;
+
+-- SELECT kll_sketch_union_agg(kll_sketch) FROM ...
+CREATE OR REPLACE AGGREGATE FUNCTION kll_sketch_union_agg AS
+    LANGUAGE 'C++'
+    NAME 'KllAggregateUnionFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION kll_sketch_union_agg(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT kll_sketch_get_quantile(kll_sketch, 0.99) FROM ...
+CREATE OR REPLACE FUNCTION kll_sketch_get_quantile AS
+    LANGUAGE 'C++'
+    NAME 'KllSketchGetQuantileFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION kll_sketch_get_quantile(LONG VARBINARY, FLOAT) TO PUBLIC;
+
+-- SELECT kll_sketch_get_quantiles(kll_sketch, '[0.5,0.9,0.99]') FROM ...
+CREATE OR REPLACE FUNCTION kll_sketch_get_quantiles AS
+    LANGUAGE 'C++'
+    NAME 'KllSketchGetQuantilesFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION kll_sketch_get_quantiles(LONG VARBINARY, VARCHAR) TO PUBLIC;
+
+-- SELECT kll_sketch_get_rank(kll_sketch, value) FROM ...
+CREATE OR REPLACE FUNCTION kll_sketch_get_rank AS
+    LANGUAGE 'C++'
+    NAME 'KllSketchGetRankFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION kll_sketch_get_rank(LONG VARBINARY, FLOAT) TO PUBLIC;
+
+-- SELECT kll_sketch_get_pmf(kll_sketch, '[10,100,1000]') FROM ...
+CREATE OR REPLACE FUNCTION kll_sketch_get_pmf AS
+    LANGUAGE 'C++'
+    NAME 'KllSketchGetPmfFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION kll_sketch_get_pmf(LONG VARBINARY, VARCHAR) TO PUBLIC;
+
+-- Bloom filters
+-- SELECT bloom_filter_create(varchar USING PARAMETERS numItems=1000000, fpp=0.01) FROM ...
+-- returns a filter as long varbinary, sized for numItems distinct values at a false positive probability of fpp
+CREATE OR REPLACE AGGREGATE FUNCTION bloom_filter_create AS
+    LANGUAGE 'C++'
+    NAME 'BloomFilterAggregateCreateVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION bloom_filter_create(VARCHAR) TO PUBLIC;
+CREATE OR REPLACE AGGREGATE FUNCTION bloom_filter_create AS
+    LANGUAGE 'C++'
+    NAME 'BloomFilterAggregateCreateIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION bloom_filter_create(INTEGER) TO PUBLIC;
+
+-- SELECT bloom_filter_contains(filter, varchar) FROM ...
+-- returns false if varchar was certainly not added to filter, true if it probably was
+CREATE OR REPLACE FUNCTION bloom_filter_contains AS
+    LANGUAGE 'C++'
+    NAME 'BloomFilterContainsVarcharFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION bloom_filter_contains(LONG VARBINARY, VARCHAR) TO PUBLIC;
+CREATE OR REPLACE FUNCTION bloom_filter_contains AS
+    LANGUAGE 'C++'
+    NAME 'BloomFilterContainsIntFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION bloom_filter_contains(LONG VARBINARY, INTEGER) TO PUBLIC;
+
+-- Bitmaps
+-- SELECT key, bitmap_create(integer USING PARAMETERS maxBytes=1000000) FROM ... GROUP BY key
+-- returns the exact set of the values as long varbinary
+CREATE OR REPLACE AGGREGATE FUNCTION bitmap_create AS
+    LANGUAGE 'C++'
+    NAME 'BitmapAggregateCreateFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION bitmap_create(INTEGER) TO PUBLIC;
+
+-- SELECT bitmap_union_agg(bitmap) FROM ...
+CREATE OR REPLACE AGGREGATE FUNCTION bitmap_union_agg AS
+    LANGUAGE 'C++'
+    NAME 'BitmapAggregateUnionFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON AGGREGATE FUNCTION bitmap_union_agg(LONG VARBINARY) TO PUBLIC;
+
+-- SELECT bitmap_and(bitmap1, bitmap2) FROM ...
+CREATE OR REPLACE FUNCTION bitmap_and AS
+    LANGUAGE 'C++'
+    NAME 'BitmapAndFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION bitmap_and(LONG VARBINARY, LONG VARBINARY) TO PUBLIC;
+
+-- SELECT bitmap_andnot(bitmap1, bitmap2) FROM ...
+CREATE OR REPLACE FUNCTION bitmap_andnot AS
+    LANGUAGE 'C++'
+    NAME 'BitmapAndNotFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION bitmap_andnot(LONG VARBINARY, LONG VARBINARY) TO PUBLIC;
+
+-- SELECT bitmap_cardinality(bitmap) FROM ...
+-- returns the number of values as integer
+CREATE OR REPLACE FUNCTION bitmap_cardinality AS
+    LANGUAGE 'C++'
+    NAME 'BitmapCardinalityFactory' LIBRARY DataSketches;
+GRANT EXECUTE ON FUNCTION bitmap_cardinality(LONG VARBINARY) TO PUBLIC;
@@ -0,0 +1,88 @@
+#include "Vertica.h"
+#include <algorithm>
+#include "../../../include/datasketches/bitmap/bitmap_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * bitmap_create(id): exact set of the integer values of a group. Values of a block are sorted first, so that they
+ * are added container by container in one pass over the bitmap.
+ */
+class BitmapAggregateCreate : public BitmapAggregateFunction {
+    std::vector<uint64_t> values;
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            values.clear();
+            do {
+                const vint value = argReader.getIntRef(0);
+                if (value != vint_null) {
+                    values.push_back(static_cast<uint64_t>(value));
+                }
+            } while (argReader.next());
+            std::sort(values.begin(), values.end());
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+            bitmap.addSorted(values.data(), values.data() + values.size());
+            LogTrace(traceLevel, TRACE_VERBOSE, srvInterface, "bitmap aggregate: %zu values added, %llu in total",
+                     values.size(), (unsigned long long) bitmap.getCardinality());
+            serializeBitmap(bitmap, aggs.getStringRef(0), maxBytes);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+/**
+ * bitmap_union_agg(bitmap): union of the bitmaps of a group.
+ */
+class BitmapAggregateUnion : public BitmapAggregateFunction {
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                const VString &bytes = argReader.getStringRef(0);
+                if (!bytes.isNull()) {
+                    bitmap.unionWith(roaring_bitmap::deserialize(bytes.data(), bytes.length()));
+                }
+            } while (argReader.next());
+            serializeBitmap(bitmap, aggs.getStringRef(0), maxBytes);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class BitmapAggregateCreateFactory : public BitmapAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addInt();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<BitmapAggregateCreate>(srvInterface.allocator);
+    }
+};
+
+class BitmapAggregateUnionFactory : public BitmapAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<BitmapAggregateUnion>(srvInterface.allocator);
+    }
+};
+
+RegisterFactory(BitmapAggregateCreateFactory);
+RegisterFactory(BitmapAggregateUnionFactory);
@@ -0,0 +1,123 @@
+#include "Vertica.h"
+#include <algorithm>
+#include "../../../include/datasketches/bitmap/bitmap_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * bitmap_and(a, b) and bitmap_andnot(a, b): exact intersection and difference of two bitmaps, NULL if either is.
+ * Results are never larger than their first input, and intersections than either input.
+ */
+template<bool AndNot>
+class BitmapSetOperation : public BitmapScalarFunction {
+    roaring_bitmap result;
+
+public:
+    virtual void processBlock(ServerInterface &srvInterface,
+                              BlockReader &argReader,
+                              BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                const VString &bytesA = argReader.getStringRef(0);
+                const VString &bytesB = argReader.getStringRef(1);
+                if (bytesA.isNull() || bytesB.isNull()) {
+                    resWriter.getStringRef().setNull();
+                } else {
+                    auto a = getBitmap(bytesA);
+                    auto b = getBitmap(bytesB);
+                    if (AndNot) {
+                        roaring_bitmap::andNot(*a, *b, result);
+                    } else {
+                        roaring_bitmap::intersection(*a, *b, result);
+                    }
+                    serializeBitmap(result, resWriter.getStringRef(), DATASKETCHES_BITMAP_MAX_SERIALIZED_SIZE);
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+template<bool AndNot>
+class BitmapSetOperationFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<BitmapSetOperation<AndNot>>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        vsize length = inputTypes.getColumnType(0).getStringLength();
+        if (!AndNot) {
+            length = std::min(length, inputTypes.getColumnType(1).getStringLength());
+        }
+        outputTypes.addLongVarbinary(length);
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+class BitmapAndFactory : public BitmapSetOperationFactory<false> {
+};
+
+class BitmapAndNotFactory : public BitmapSetOperationFactory<true> {
+};
+
+/**
+ * bitmap_cardinality(bitmap): number of values of a bitmap, read from its header.
+ */
+class BitmapCardinality : public ScalarFunction {
+public:
+    virtual void processBlock(ServerInterface &srvInterface,
+                              BlockReader &argReader,
+                              BlockWriter &resWriter) {
+        try {
+            do {
+                const VString &bytes = argReader.getStringRef(0);
+                if (bytes.isNull()) {
+                    resWriter.setInt(vint_null);
+                } else {
+                    resWriter.setInt(static_cast<vint>(roaring_bitmap::readCardinality(bytes.data(), bytes.length())));
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class BitmapCardinalityFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<BitmapCardinality>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addInt();
+    }
+};
+
+RegisterFactory(BitmapAndFactory);
+RegisterFactory(BitmapAndNotFactory);
+RegisterFactory(BitmapCardinalityFactory);
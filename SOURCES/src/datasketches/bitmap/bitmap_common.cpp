@@ -0,0 +1,85 @@
+#include <stdexcept>
+#include <string>
+#include "../../../include/datasketches/bitmap/bitmap_common.hpp"
+
+size_t readBitmapMaxBytes(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_BITMAP_MAX_BYTES_PARAMETER_NAME)) {
+        vint maxBytes = paramReader.getIntRef(DATASKETCHES_BITMAP_MAX_BYTES_PARAMETER_NAME);
+        if (maxBytes < static_cast<vint>(roaring_bitmap::HEADER_BYTES) || maxBytes > DATASKETCHES_BITMAP_MAX_SERIALIZED_SIZE) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_BITMAP_MAX_BYTES_PARAMETER_NAME, (int) roaring_bitmap::HEADER_BYTES,
+                            DATASKETCHES_BITMAP_MAX_SERIALIZED_SIZE);
+        }
+        return maxBytes;
+    }
+    return DATASKETCHES_BITMAP_MAX_BYTES_DEFAULT;
+}
+
+void addBitmapMaxBytesParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties maxBytesProps;
+    maxBytesProps.required = false;
+    maxBytesProps.canBeNull = false;
+    maxBytesProps.comment = "Largest serialized bitmap, in bytes.";
+    parameterTypes.addInt(DATASKETCHES_BITMAP_MAX_BYTES_PARAMETER_NAME, maxBytesProps);
+}
+
+void serializeBitmap(const roaring_bitmap &bitmap, VString &out, size_t maxBytes) {
+    const size_t size = bitmap.getSerializedSize();
+    if (size > maxBytes) {
+        throw std::length_error("bitmap of " + std::to_string(bitmap.getCardinality()) + " values takes "
+                                + std::to_string(size) + " bytes, more than the " + std::to_string(maxBytes)
+                                + " bytes of maxBytes");
+    }
+    out.alloc(size);
+    out.setLen(bitmap.serialize(out.data()));
+}
+
+void BitmapAggregateFunction::setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+    this->maxBytes = readBitmapMaxBytes(srvInterface);
+    this->traceLevel = readTraceLevel(srvInterface);
+}
+
+void BitmapAggregateFunction::initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+    try {
+        bitmap.clear();
+        serializeBitmap(bitmap, aggs.getStringRef(0), maxBytes);
+    } catch (std::exception &e) {
+        // Standard exception. Quit.
+        vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+    }
+}
+
+void BitmapAggregateFunction::combine(ServerInterface &srvInterface,
+                                      IntermediateAggs &aggs,
+                                      MultipleIntermediateAggs &aggsOther) {
+    try {
+        const VString &current = aggs.getStringRef(0);
+        roaring_bitmap result = roaring_bitmap::deserialize(current.data(), current.length());
+        int merged = 0;
+        do {
+            const VString &other = aggsOther.getStringRef(0);
+            result.unionWith(roaring_bitmap::deserialize(other.data(), other.length()));
+            merged++;
+        } while (aggsOther.next());
+        LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "bitmap combine: merged %d bitmaps, %llu values", merged,
+                 (unsigned long long) result.getCardinality());
+        serializeBitmap(result, aggs.getStringRef(0), maxBytes);
+    } catch (std::exception &e) {
+        // Standard exception. Quit.
+        vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+    }
+}
+
+void BitmapAggregateFunction::terminate(ServerInterface &srvInterface,
+                                        BlockWriter &resWriter,
+                                        IntermediateAggs &aggs) {
+    try {
+        resWriter.getStringRef().copy(&aggs.getStringRef(0));
+    } catch (std::exception &e) {
+        // Standard exception. Quit.
+        vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
+    }
+}
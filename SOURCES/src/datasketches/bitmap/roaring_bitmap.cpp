@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include "../../../include/datasketches/bitmap/roaring_bitmap.hpp"
+
+typedef roaring_bitmap::container container;
+
+static const size_t BITMAP_WORDS = roaring_bitmap::BITMAP_WORDS;
+static const size_t CONTAINER_HEADER_BYTES = sizeof(uint64_t) + sizeof(uint32_t);
+
+static void setBit(uint64_t *words, uint16_t value) {
+    words[value >> 6] |= 1ULL << (value & 63);
+}
+
+static bool testBit(const uint64_t *words, uint16_t value) {
+    return (words[value >> 6] >> (value & 63)) & 1;
+}
+
+static uint32_t countBits(const uint64_t *words) {
+    uint32_t count = 0;
+    for (size_t i = 0; i < BITMAP_WORDS; i++) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+static void toBitmap(container &c) {
+    c.words.assign(BITMAP_WORDS, 0);
+    for (uint16_t value: c.values) {
+        setBit(c.words.data(), value);
+    }
+    std::vector<uint16_t>().swap(c.values);
+}
+
+static void toArray(container &c) {
+    c.values.clear();
+    c.values.reserve(c.cardinality);
+    for (size_t i = 0; i < BITMAP_WORDS; i++) {
+        for (uint64_t word = c.words[i]; word != 0; word &= word - 1) {
+            c.values.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(word)));
+        }
+    }
+    std::vector<uint64_t>().swap(c.words);
+}
+
+/**
+ * Converts a container to the representation of its cardinality.
+ */
+static void normalize(container &c) {
+    if (c.isBitmap() && c.cardinality <= roaring_bitmap::ARRAY_MAX) {
+        toArray(c);
+    } else if (!c.isBitmap() && c.cardinality > roaring_bitmap::ARRAY_MAX) {
+        toBitmap(c);
+    }
+}
+
+static void resetArray(container &out) {
+    out.values.clear();
+    out.words.clear();
+}
+
+static void resetBitmap(container &out) {
+    out.values.clear();
+    out.words.resize(BITMAP_WORDS);
+}
+
+static void orContainers(const container &a, const container &b, container &out) {
+    if (!a.isBitmap() && !b.isBitmap()) {
+        resetArray(out);
+        out.values.reserve(a.values.size() + b.values.size());
+        std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                       std::back_inserter(out.values));
+        out.cardinality = static_cast<uint32_t>(out.values.size());
+        normalize(out);
+        return;
+    }
+    if (a.isBitmap() != b.isBitmap()) {
+        const container &bitmap = a.isBitmap() ? a : b;
+        const container &array = a.isBitmap() ? b : a;
+        resetBitmap(out);
+        std::copy(bitmap.words.begin(), bitmap.words.end(), out.words.begin());
+        out.cardinality = bitmap.cardinality;
+        for (uint16_t value: array.values) {
+            out.cardinality += !testBit(out.words.data(), value);
+            setBit(out.words.data(), value);
+        }
+        return;
+    }
+    resetBitmap(out);
+    const uint64_t *wordsA = a.words.data();
+    const uint64_t *wordsB = b.words.data();
+    uint64_t *words = out.words.data();
+    for (size_t i = 0; i < BITMAP_WORDS; i++) {
+        words[i] = wordsA[i] | wordsB[i];
+    }
+    out.cardinality = countBits(words);
+}
+
+static void andContainers(const container &a, const container &b, container &out) {
+    if (!a.isBitmap() && !b.isBitmap()) {
+        resetArray(out);
+        std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                              std::back_inserter(out.values));
+        out.cardinality = static_cast<uint32_t>(out.values.size());
+        return;
+    }
+    if (a.isBitmap() != b.isBitmap()) {
+        const container &bitmap = a.isBitmap() ? a : b;
+        const container &array = a.isBitmap() ? b : a;
+        resetArray(out);
+        for (uint16_t value: array.values) {
+            if (testBit(bitmap.words.data(), value)) {
+                out.values.push_back(value);
+            }
+        }
+        out.cardinality = static_cast<uint32_t>(out.values.size());
+        return;
+    }
+    resetBitmap(out);
+    const uint64_t *wordsA = a.words.data();
+    const uint64_t *wordsB = b.words.data();
+    uint64_t *words = out.words.data();
+    for (size_t i = 0; i < BITMAP_WORDS; i++) {
+        words[i] = wordsA[i] & wordsB[i];
+    }
+    out.cardinality = countBits(words);
+    normalize(out);
+}
+
+static void andNotContainers(const container &a, const container &b, container &out) {
+    if (!a.isBitmap()) {
+        resetArray(out);
+        if (b.isBitmap()) {
+            for (uint16_t value: a.values) {
+                if (!testBit(b.words.data(), value)) {
+                    out.values.push_back(value);
+                }
+            }
+        } else {
+            std::set_difference(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                std::back_inserter(out.values));
+        }
+        out.cardinality = static_cast<uint32_t>(out.values.size());
+        return;
+    }
+    resetBitmap(out);
+    uint64_t *words = out.words.data();
+    if (b.isBitmap()) {
+        const uint64_t *wordsA = a.words.data();
+        const uint64_t *wordsB = b.words.data();
+        for (size_t i = 0; i < BITMAP_WORDS; i++) {
+            words[i] = wordsA[i] & ~wordsB[i];
+        }
+        out.cardinality = countBits(words);
+    } else {
+        std::copy(a.words.begin(), a.words.end(), out.words.begin());
+        out.cardinality = a.cardinality;
+        for (uint16_t value: b.values) {
+            out.cardinality -= testBit(words, value);
+            words[value >> 6] &= ~(1ULL << (value & 63));
+        }
+    }
+    normalize(out);
+}
+
+/**
+ * Adds the low 16 bits of sorted values (of the key of c) to c.
+ */
+static void addToContainer(container &c, const uint64_t *begin, const uint64_t *end) {
+    const size_t numValues = end - begin;
+    if (!c.isBitmap() && c.cardinality + numValues <= roaring_bitmap::ARRAY_MAX) {
+        std::vector<uint16_t> merged;
+        merged.reserve(c.values.size() + numValues);
+        auto i = c.values.begin();
+        for (const uint64_t *value = begin; value < end; value++) {
+            const uint16_t low = static_cast<uint16_t>(*value);
+            while (i != c.values.end() && *i < low) {
+                merged.push_back(*i++);
+            }
+            if (i != c.values.end() && *i == low) {
+                i++;
+            }
+            merged.push_back(low);
+        }
+        merged.insert(merged.end(), i, c.values.end());
+        c.values.swap(merged);
+        c.cardinality = static_cast<uint32_t>(c.values.size());
+        return;
+    }
+    if (!c.isBitmap()) {
+        toBitmap(c);
+    }
+    uint64_t *words = c.words.data();
+    for (const uint64_t *value = begin; value < end; value++) {
+        const uint16_t low = static_cast<uint16_t>(*value);
+        c.cardinality += !testBit(words, low);
+        setBit(words, low);
+    }
+    normalize(c);
+}
+
+roaring_bitmap::roaring_bitmap() : cardinality(0) {
+}
+
+void roaring_bitmap::clear() {
+    cardinality = 0;
+    keys.clear();
+    containers.clear();
+}
+
+void roaring_bitmap::append(uint64_t key, container &c) {
+    if (c.cardinality == 0) {
+        return;
+    }
+    keys.push_back(key);
+    containers.push_back(std::move(c));
+    cardinality += containers.back().cardinality;
+}
+
+void roaring_bitmap::addSorted(const uint64_t *begin, const uint64_t *end) {
+    roaring_bitmap result;
+    result.keys.reserve(keys.size());
+    result.containers.reserve(containers.size());
+    size_t i = 0;
+    const uint64_t *value = begin;
+    while (i < keys.size() || value < end) {
+        if (value == end || (i < keys.size() && keys[i] < (*value >> 16))) {
+            result.append(keys[i], containers[i]);
+            i++;
+            continue;
+        }
+        const uint64_t key = *value >> 16;
+        const uint64_t *groupEnd = value;
+        while (groupEnd < end && (*groupEnd >> 16) == key) {
+            groupEnd++;
+        }
+        container c;
+        c.cardinality = 0;
+        if (i < keys.size() && keys[i] == key) {
+            c = std::move(containers[i]);
+            i++;
+        }
+        addToContainer(c, value, groupEnd);
+        result.append(key, c);
+        value = groupEnd;
+    }
+    std::swap(*this, result);
+}
+
+void roaring_bitmap::unionWith(const roaring_bitmap &other) {
+    roaring_bitmap result;
+    result.keys.reserve(keys.size() + other.keys.size());
+    result.containers.reserve(keys.size() + other.keys.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < keys.size() || j < other.keys.size()) {
+        if (j == other.keys.size() || (i < keys.size() && keys[i] < other.keys[j])) {
+            result.append(keys[i], containers[i]);
+            i++;
+        } else if (i == keys.size() || other.keys[j] < keys[i]) {
+            container c = other.containers[j];
+            result.append(other.keys[j], c);
+            j++;
+        } else {
+            container c;
+            orContainers(containers[i], other.containers[j], c);
+            result.append(keys[i], c);
+            i++;
+            j++;
+        }
+    }
+    std::swap(*this, result);
+}
+
+void roaring_bitmap::intersection(const roaring_bitmap &a, const roaring_bitmap &b, roaring_bitmap &out) {
+    out.clear();
+    size_t i = 0;
+    size_t j = 0;
+    container c;
+    while (i < a.keys.size() && j < b.keys.size()) {
+        if (a.keys[i] < b.keys[j]) {
+            i++;
+        } else if (b.keys[j] < a.keys[i]) {
+            j++;
+        } else {
+            andContainers(a.containers[i], b.containers[j], c);
+            out.append(a.keys[i], c);
+            i++;
+            j++;
+        }
+    }
+}
+
+void roaring_bitmap::andNot(const roaring_bitmap &a, const roaring_bitmap &b, roaring_bitmap &out) {
+    out.clear();
+    size_t j = 0;
+    container c;
+    for (size_t i = 0; i < a.keys.size(); i++) {
+        while (j < b.keys.size() && b.keys[j] < a.keys[i]) {
+            j++;
+        }
+        if (j < b.keys.size() && b.keys[j] == a.keys[i]) {
+            andNotContainers(a.containers[i], b.containers[j], c);
+        } else {
+            c = a.containers[i];
+        }
+        out.append(a.keys[i], c);
+    }
+}
+
+size_t roaring_bitmap::getSerializedSize() const {
+    size_t size = HEADER_BYTES;
+    for (const container &c: containers) {
+        size += CONTAINER_HEADER_BYTES
+                + (c.isBitmap() ? BITMAP_WORDS * sizeof(uint64_t) : c.values.size() * sizeof(uint16_t));
+    }
+    return size;
+}
+
+size_t roaring_bitmap::serialize(char *out) const {
+    char *p = out;
+    const uint32_t numContainers = static_cast<uint32_t>(containers.size());
+    *p++ = SERIAL_VERSION;
+    *p++ = FAMILY;
+    *p++ = 0;
+    *p++ = 0;
+    std::memcpy(p, &numContainers, sizeof(numContainers));
+    p += sizeof(numContainers);
+    std::memcpy(p, &cardinality, sizeof(cardinality));
+    p += sizeof(cardinality);
+    for (size_t i = 0; i < containers.size(); i++) {
+        const container &c = containers[i];
+        std::memcpy(p, &keys[i], sizeof(uint64_t));
+        p += sizeof(uint64_t);
+        std::memcpy(p, &c.cardinality, sizeof(uint32_t));
+        p += sizeof(uint32_t);
+        if (c.isBitmap()) {
+            std::memcpy(p, c.words.data(), BITMAP_WORDS * sizeof(uint64_t));
+            p += BITMAP_WORDS * sizeof(uint64_t);
+        } else {
+            std::memcpy(p, c.values.data(), c.values.size() * sizeof(uint16_t));
+            p += c.values.size() * sizeof(uint16_t);
+        }
+    }
+    return p - out;
+}
+
+static void checkHeader(const char *data, size_t length) {
+    if (length < roaring_bitmap::HEADER_BYTES || static_cast<uint8_t>(data[1]) != roaring_bitmap::FAMILY) {
+        throw std::invalid_argument("not a bitmap");
+    }
+    if (static_cast<uint8_t>(data[0]) != roaring_bitmap::SERIAL_VERSION) {
+        throw std::invalid_argument("unsupported bitmap serial version " + std::to_string(static_cast<uint8_t>(data[0])));
+    }
+}
+
+uint64_t roaring_bitmap::readCardinality(const char *data, size_t length) {
+    checkHeader(data, length);
+    uint64_t result;
+    std::memcpy(&result, data + 8, sizeof(result));
+    return result;
+}
+
+roaring_bitmap roaring_bitmap::deserialize(const char *data, size_t length) {
+    checkHeader(data, length);
+    uint32_t numContainers;
+    std::memcpy(&numContainers, data + 4, sizeof(numContainers));
+    const uint64_t expectedCardinality = readCardinality(data, length);
+
+    roaring_bitmap result;
+    result.keys.reserve(numContainers);
+    result.containers.reserve(numContainers);
+    const char *p = data + HEADER_BYTES;
+    const char *end = data + length;
+    for (uint32_t i = 0; i < numContainers; i++) {
+        if (static_cast<size_t>(end - p) < CONTAINER_HEADER_BYTES) {
+            throw std::invalid_argument("bitmap truncated");
+        }
+        uint64_t key;
+        container c;
+        std::memcpy(&key, p, sizeof(key));
+        p += sizeof(key);
+        std::memcpy(&c.cardinality, p, sizeof(c.cardinality));
+        p += sizeof(c.cardinality);
+        if ((!result.keys.empty() && key <= result.keys.back()) || key >> 48 != 0
+            || c.cardinality == 0 || c.cardinality > (1U << 16)) {
+            throw std::invalid_argument("corrupted bitmap container " + std::to_string(i));
+        }
+
+        const bool bitmap = c.cardinality > ARRAY_MAX;
+        const size_t payload = bitmap ? BITMAP_WORDS * sizeof(uint64_t) : c.cardinality * sizeof(uint16_t);
+        if (static_cast<size_t>(end - p) < payload) {
+            throw std::invalid_argument("bitmap truncated");
+        }
+        bool valid;
+        if (bitmap) {
+            c.words.resize(BITMAP_WORDS);
+            std::memcpy(c.words.data(), p, payload);
+            valid = countBits(c.words.data()) == c.cardinality;
+        } else {
+            c.values.resize(c.cardinality);
+            std::memcpy(c.values.data(), p, payload);
+            valid = std::adjacent_find(c.values.begin(), c.values.end(), std::greater_equal<uint16_t>())
+                    == c.values.end();
+        }
+        if (!valid) {
+            throw std::invalid_argument("corrupted bitmap container " + std::to_string(i));
+        }
+        p += payload;
+        result.append(key, c);
+    }
+    if (p != end || result.cardinality != expectedCardinality) {
+        throw std::invalid_argument("corrupted bitmap");
+    }
+    return result;
+}
@@ -0,0 +1,113 @@
+#include "Vertica.h"
+#include <memory>
+#include "../../../include/datasketches/bloom/bloom_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * bloom_filter_contains(filter, value): false if value was certainly not added to filter, true if it probably was.
+ * NULL when the filter or value is NULL.
+ *
+ * Filters are probed in place. The filter is usually the same for all rows (a constant or a scalar subquery), so
+ * it is only wrapped and checked again when the address or length of its bytes changes. Rows are processed in
+ * batches: all values of a batch are hashed and the blocks they fall in prefetched before any is probed, so that
+ * the cache misses of large filters overlap instead of being paid one after the other.
+ */
+template<class Values>
+class BloomFilterContains : public ScalarFunction {
+protected:
+    static const size_t BATCH_SIZE = 32;
+
+    struct Probe {
+        const char *block;
+        HashState hashes;
+    };
+
+    uint64_t seed;
+    uint16_t seedHash;
+    Probe probes[BATCH_SIZE];
+    // Filter of the last row, while its bytes are unchanged. Reset with every block, whose memory may be reused.
+    std::unique_ptr<bloom_filter> filter;
+    const char *filterData;
+    size_t filterLength;
+
+    const bloom_filter &getFilter(const VString &bytes) {
+        if (!filter || bytes.data() != filterData || bytes.length() != filterLength) {
+            filter.reset(new bloom_filter(bytes.data(), bytes.length(), seedHash));
+            filterData = bytes.data();
+            filterLength = bytes.length();
+        }
+        return *filter;
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->seed = readSeed(srvInterface);
+        this->seedHash = computeSeedHash(seed);
+    }
+
+    virtual void processBlock(ServerInterface &srvInterface,
+                              BlockReader &argReader,
+                              BlockWriter &resWriter) {
+        try {
+            filter.reset();
+            bool more = true;
+            while (more) {
+                size_t numProbes = 0;
+                do {
+                    Probe &probe = probes[numProbes++];
+                    probe.block = nullptr;
+                    const VString &bytes = argReader.getStringRef(0);
+                    if (!bytes.isNull() && Values::hash(argReader, 1, seed, probe.hashes)) {
+                        probe.block = getFilter(bytes).blockAddress(probe.hashes);
+                        __builtin_prefetch(probe.block);
+                    }
+                    more = argReader.next();
+                } while (more && numProbes < BATCH_SIZE);
+
+                for (size_t i = 0; i < numProbes; i++) {
+                    if (probes[i].block == nullptr) {
+                        resWriter.setBool(vbool_null);
+                    } else {
+                        resWriter.setBool(bloom_filter::blockContains(probes[i].block, probes[i].hashes)
+                                          ? vbool_true : vbool_false);
+                    }
+                    resWriter.next();
+                }
+            }
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+template<class Values>
+class BloomFilterContainsFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<BloomFilterContains<Values>>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        Values::addArgumentType(argTypes);
+        returnType.addBool();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+    }
+};
+
+class BloomFilterContainsVarcharFactory : public BloomFilterContainsFactory<BloomVarcharValues> {
+};
+
+class BloomFilterContainsIntFactory : public BloomFilterContainsFactory<BloomIntValues> {
+};
+
+RegisterFactory(BloomFilterContainsVarcharFactory);
+RegisterFactory(BloomFilterContainsIntFactory);
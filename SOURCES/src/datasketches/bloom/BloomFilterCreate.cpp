@@ -0,0 +1,130 @@
+#include "Vertica.h"
+#include "../../../include/datasketches/bloom/bloom_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function building a bloom_filter of its values, sized by the numItems and fpp parameters.
+ * The filter is updated in place in the intermediate aggregate, and combined by OR-ing filters, so no filter is
+ * ever copied or deserialized.
+ */
+template<class Values>
+class BloomFilterAggregateCreate : public AggregateFunction {
+protected:
+    uint32_t numBlocks;
+    uint64_t seed;
+    uint16_t seedHash;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->numBlocks = readBloomNumBlocks(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->seedHash = computeSeedHash(seed);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            VString &filter = aggs.getStringRef(0);
+            const size_t size = bloom_filter::getSerializedSize(numBlocks);
+            filter.alloc(size);
+            bloom_filter::initialize(filter.data(), numBlocks, seedHash);
+            filter.setLen(size);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            VString &bytes = aggs.getStringRef(0);
+            bloom_filter filter(bytes.data(), bytes.length(), seedHash);
+            HashState hashes;
+            do {
+                if (Values::hash(argReader, 0, seed, hashes)) {
+                    filter.insert(hashes);
+                }
+            } while (argReader.next());
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            VString &bytes = aggs.getStringRef(0);
+            bloom_filter filter(bytes.data(), bytes.length(), seedHash);
+            int merged = 0;
+            do {
+                const VString &other = aggsOther.getStringRef(0);
+                filter.merge(bloom_filter(other.data(), other.length(), seedHash));
+                merged++;
+            } while (aggsOther.next());
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "bloom filter combine: merged %d filters", merged);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void terminate(ServerInterface &srvInterface,
+                           BlockWriter &resWriter,
+                           IntermediateAggs &aggs) override {
+        try {
+            resWriter.getStringRef().copy(&aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+template<class Values>
+class BloomFilterAggregateCreateFactory : public AggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        Values::addArgumentType(argTypes);
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        intermediateTypeMetaData.addLongVarbinary(bloom_filter::getSerializedSize(readBloomNumBlocks(srvInterface)));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(bloom_filter::getSerializedSize(readBloomNumBlocks(srvfloaterface)));
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addBloomSizeParameters(parameterTypes);
+        addSeedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<BloomFilterAggregateCreate<Values>>(srvInterface.allocator);
+    }
+};
+
+class BloomFilterAggregateCreateVarcharFactory : public BloomFilterAggregateCreateFactory<BloomVarcharValues> {
+};
+
+class BloomFilterAggregateCreateIntFactory : public BloomFilterAggregateCreateFactory<BloomIntValues> {
+};
+
+RegisterFactory(BloomFilterAggregateCreateVarcharFactory);
+RegisterFactory(BloomFilterAggregateCreateIntFactory);
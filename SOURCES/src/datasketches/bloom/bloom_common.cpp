@@ -0,0 +1,45 @@
+#include "../../../include/datasketches/bloom/bloom_common.hpp"
+
+uint32_t readBloomNumBlocks(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+    vint numItems = DATASKETCHES_BLOOM_NUM_ITEMS_DEFAULT;
+    if (paramReader.containsParameter(DATASKETCHES_BLOOM_NUM_ITEMS_PARAMETER_NAME)) {
+        numItems = paramReader.getIntRef(DATASKETCHES_BLOOM_NUM_ITEMS_PARAMETER_NAME);
+        if (numItems < 1) {
+            vt_report_error(2, "Provided value of the %s parameter is not supported. The value should be at least 1",
+                            DATASKETCHES_BLOOM_NUM_ITEMS_PARAMETER_NAME);
+        }
+    }
+    vfloat fpp = DATASKETCHES_BLOOM_FPP_DEFAULT;
+    if (paramReader.containsParameter(DATASKETCHES_BLOOM_FPP_PARAMETER_NAME)) {
+        fpp = paramReader.getFloatRef(DATASKETCHES_BLOOM_FPP_PARAMETER_NAME);
+        if (!(fpp > 0 && fpp < 1)) {
+            vt_report_error(2, "Provided value of the %s parameter is not supported. The value should be between 0 and 1, exclusive",
+                            DATASKETCHES_BLOOM_FPP_PARAMETER_NAME);
+        }
+    }
+
+    const uint64_t numBlocks = bloom_filter::numBlocksFor(numItems, fpp);
+    const uint64_t maxBlocks = (DATASKETCHES_BLOOM_MAX_SERIALIZED_SIZE - bloom_filter::HEADER_BYTES)
+                               / bloom_filter::BLOCK_BYTES;
+    if (numBlocks > maxBlocks) {
+        vt_report_error(2, "A bloom filter of %lld items with a false positive probability of %g needs %llu bytes, "
+                           "more than the %d bytes of a LONG VARBINARY", (long long) numItems, fpp,
+                        (unsigned long long) (numBlocks * bloom_filter::BLOCK_BYTES), DATASKETCHES_BLOOM_MAX_SERIALIZED_SIZE);
+    }
+    return static_cast<uint32_t>(numBlocks);
+}
+
+void addBloomSizeParameters(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties numItemsProps;
+    numItemsProps.required = false;
+    numItemsProps.canBeNull = false;
+    numItemsProps.comment = "Expected number of distinct values.";
+    parameterTypes.addInt(DATASKETCHES_BLOOM_NUM_ITEMS_PARAMETER_NAME, numItemsProps);
+
+    SizedColumnTypes::Properties fppProps;
+    fppProps.required = false;
+    fppProps.canBeNull = false;
+    fppProps.comment = "False positive probability at numItems distinct values.";
+    parameterTypes.addFloat(DATASKETCHES_BLOOM_FPP_PARAMETER_NAME, fppProps);
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include "../../../include/datasketches/bloom/bloom_filter.hpp"
+
+// Odd multipliers of Parquet split block Bloom filters.
+const uint32_t bloom_filter::SALTS[bloom_filter::BLOCK_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+/**
+ * False positive probability of a split block filter holding on average load values per block. The values of a
+ * block follow a Poisson distribution, and a block of n values answers a probe positively with probability
+ * (1 - (1 - 1/64)^n)^8, one bit being tested in each of its words.
+ */
+static double blockFpp(double load) {
+    const double wordBits = 8 * sizeof(uint64_t);
+    const size_t maxValues = static_cast<size_t>(load + 10 * std::sqrt(load) + 20);
+    double fpp = 0;
+    for (size_t n = 0; n <= maxValues; n++) {
+        const double probability = std::exp(n * std::log(load) - load - std::lgamma(n + 1.0));
+        fpp += probability * std::pow(1 - std::pow(1 - 1 / wordBits, static_cast<double>(n)), bloom_filter::BLOCK_WORDS);
+    }
+    return fpp;
+}
+
+uint64_t bloom_filter::numBlocksFor(uint64_t numItems, double fpp) {
+    // Largest load per block meeting fpp, blockFpp() growing with the load.
+    double low = 0;
+    double high = BLOCK_BYTES * 8;
+    for (int i = 0; i < 64; i++) {
+        const double load = (low + high) / 2;
+        if (blockFpp(load) <= fpp) {
+            low = load;
+        } else {
+            high = load;
+        }
+    }
+    if (low <= 0) {
+        return numItems;
+    }
+    const uint64_t numBlocks = static_cast<uint64_t>(std::ceil(numItems / low));
+    return numBlocks == 0 ? 1 : numBlocks;
+}
+
+void bloom_filter::initialize(char *data, uint32_t numBlocks, uint16_t seedHash) {
+    data[0] = SERIAL_VERSION;
+    data[1] = 0;
+    std::memcpy(data + 2, &seedHash, sizeof(seedHash));
+    std::memcpy(data + 4, &numBlocks, sizeof(numBlocks));
+    std::memset(data + HEADER_BYTES, 0, static_cast<size_t>(numBlocks) * BLOCK_BYTES);
+}
+
+bloom_filter::bloom_filter(const char *data, size_t length, uint16_t seedHash) : blocks(data + HEADER_BYTES) {
+    if (length < HEADER_BYTES || data[0] != SERIAL_VERSION) {
+        throw std::invalid_argument("not a bloom filter");
+    }
+    uint16_t filterSeedHash;
+    std::memcpy(&filterSeedHash, data + 2, sizeof(filterSeedHash));
+    if (filterSeedHash != seedHash) {
+        throw std::invalid_argument("bloom filter seed hash mismatch: expected " + std::to_string(seedHash)
+                                    + ", got " + std::to_string(filterSeedHash));
+    }
+    std::memcpy(&numBlocks, data + 4, sizeof(numBlocks));
+    if (numBlocks == 0 || length != getSerializedSize(numBlocks)) {
+        throw std::invalid_argument("bloom filter of " + std::to_string(length) + " bytes is truncated or corrupted");
+    }
+}
+
+void bloom_filter::merge(const bloom_filter &other) {
+    if (other.numBlocks != numBlocks) {
+        throw std::invalid_argument("cannot merge bloom filters of " + std::to_string(numBlocks) + " and "
+                                    + std::to_string(other.numBlocks) + " blocks, use the same numItems and fpp");
+    }
+    char *target = const_cast<char *>(blocks);
+    const size_t length = static_cast<size_t>(numBlocks) * BLOCK_BYTES;
+    for (size_t offset = 0; offset < length; offset += BLOCK_BYTES) {
+        uint64_t words[BLOCK_WORDS];
+        uint64_t otherWords[BLOCK_WORDS];
+        std::memcpy(words, target + offset, BLOCK_BYTES);
+        std::memcpy(otherWords, other.blocks + offset, BLOCK_BYTES);
+        for (size_t i = 0; i < BLOCK_WORDS; i++) {
+            words[i] |= otherWords[i];
+        }
+        std::memcpy(target + offset, words, BLOCK_BYTES);
+    }
+}
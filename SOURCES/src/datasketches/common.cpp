@@ -0,0 +1,91 @@
+#include <Vertica.h>
+#include <algorithm>
+#include <thread>
+#include "../../include/datasketches/common.hpp"
+
+
+uint64_t readSeed(ServerInterface &serverInterface) {
+    vint seed;
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_SEED_PARAMETER_NAME)) {
+        seed = paramReader.getIntRef(DATASKETCHES_SEED_PARAMETER_NAME);
+    } else {
+        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
+                        DATASKETCHES_SEED_PARAMETER_NAME, DATASKETCHES_SEED_DEFAULT);
+        seed = DATASKETCHES_SEED_DEFAULT;
+    }
+    return seed;
+}
+
+uint32_t readCacheSize(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_CACHE_SIZE_PARAMETER_NAME)) {
+        vint cacheSize = paramReader.getIntRef(DATASKETCHES_CACHE_SIZE_PARAMETER_NAME);
+        if (cacheSize < 0 || cacheSize > DATASKETCHES_CACHE_SIZE_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_CACHE_SIZE_PARAMETER_NAME, 0, DATASKETCHES_CACHE_SIZE_MAX);
+        }
+        return cacheSize;
+    }
+    return DATASKETCHES_CACHE_SIZE_DEFAULT;
+}
+
+unsigned readThreads(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_THREADS_PARAMETER_NAME)) {
+        vint threads = paramReader.getIntRef(DATASKETCHES_THREADS_PARAMETER_NAME);
+        if (threads < 1 || threads > DATASKETCHES_THREADS_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_THREADS_PARAMETER_NAME, 1, DATASKETCHES_THREADS_MAX);
+        }
+        return threads;
+    }
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads == 0 ? 1 : std::min<unsigned>(hardwareThreads, DATASKETCHES_THREADS_MAX);
+}
+
+size_t readWindow(ServerInterface &serverInterface) {
+    vint window = serverInterface.getParamReader().getIntRef(DATASKETCHES_WINDOW_PARAMETER_NAME);
+    if (window < 1) {
+        vt_report_error(2, "Provided value of the %s parameter is not supported. The value should be at least 1",
+                        DATASKETCHES_WINDOW_PARAMETER_NAME);
+    }
+    return window;
+}
+
+void addSeedParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties seedProps;
+    seedProps.required = false;
+    seedProps.canBeNull = false;
+    seedProps.comment = "Seed value";
+    parameterTypes.addInt(DATASKETCHES_SEED_PARAMETER_NAME, seedProps);
+}
+
+void addCacheSizeParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties cacheSizeProps;
+    cacheSizeProps.required = false;
+    cacheSizeProps.canBeNull = false;
+    cacheSizeProps.comment = "Number of deserialized input sketches kept by each function instance, 0 disables it.";
+    parameterTypes.addInt(DATASKETCHES_CACHE_SIZE_PARAMETER_NAME, cacheSizeProps);
+}
+
+void addThreadsParameter(SizedColumnTypes &parameterTypes, const char *comment) {
+    SizedColumnTypes::Properties threadsProps;
+    threadsProps.required = false;
+    threadsProps.canBeNull = false;
+    threadsProps.comment = comment;
+    parameterTypes.addInt(DATASKETCHES_THREADS_PARAMETER_NAME, threadsProps);
+}
+
+void addWindowParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties windowProps;
+    windowProps.required = true;
+    windowProps.canBeNull = false;
+    windowProps.comment = "Number of panes (distinct ORDER BY values) in the window, the current one included.";
+    parameterTypes.addInt(DATASKETCHES_WINDOW_PARAMETER_NAME, windowProps);
+}
@@ -0,0 +1,72 @@
+#include "Vertica.h"
+#include <memory>
+#include "../../../include/datasketches/cpc/cpc_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function that builds a cpc_sketch and returns it serialized.
+ * Based on example from https://datasketches.apache.org/docs/CPC/CpcCppExample.html
+ *
+ * The sketch stays live across the blocks of a group and is only serialized at the end of each block.
+ * Items reads the argument column and feeds the sketch.
+ */
+template<class Items>
+class CpcAggregateCreate : public CpcSketchAggregateFunction {
+protected:
+    std::unique_ptr<datasketches::cpc_sketch> sketch;
+    Items items;
+
+public:
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            sketch.reset(new datasketches::cpc_sketch(logK, seed));
+            serializeCpcSketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                items.update(*sketch, argReader);
+            } while (argReader.next());
+            serializeCpcSketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+template<class Items>
+class CpcAggregateCreateFactoryBase : public CpcSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        Items::addArgumentType(argTypes);
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<CpcAggregateCreate<Items>>(srvfloaterface.allocator);
+    }
+};
+
+class CpcAggregateCreateVarcharFactory : public CpcAggregateCreateFactoryBase<CpcVarcharItems> {
+};
+
+class CpcAggregateCreateIntFactory : public CpcAggregateCreateFactoryBase<CpcIntItems> {
+};
+
+class CpcAggregateCreateVarbinaryFactory : public CpcAggregateCreateFactoryBase<CpcVarbinaryItems> {
+};
+
+RegisterFactory(CpcAggregateCreateVarcharFactory);
+RegisterFactory(CpcAggregateCreateIntFactory);
+RegisterFactory(CpcAggregateCreateVarbinaryFactory);
@@ -0,0 +1,53 @@
+#include "Vertica.h"
+#include <memory>
+#include "../../../include/datasketches/cpc/cpc_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function merging serialized cpc_sketch, as returned by cpc_sketch_create.
+ * The union stays live across the blocks of a group, like the sketch of cpc_sketch_create.
+ */
+class CpcAggregateUnion : public CpcSketchAggregateFunction {
+protected:
+    std::unique_ptr<datasketches::cpc_union> u;
+
+public:
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        CpcSketchAggregateFunction::initAggregate(srvInterface, aggs);
+        u.reset(new datasketches::cpc_union(logK, seed));
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                const VString &sketch = argReader.getStringRef(0);
+                if (!sketch.isNull()) {
+                    u->update(datasketches::cpc_sketch::deserialize(sketch.data(), sketch.length(), seed));
+                }
+            } while (argReader.next());
+            serializeCpcSketch(u->get_result(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class CpcAggregateUnionFactory : public CpcSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<CpcAggregateUnion>(srvfloaterface.allocator);
+    }
+};
+
+RegisterFactory(CpcAggregateUnionFactory);
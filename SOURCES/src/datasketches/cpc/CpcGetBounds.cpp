@@ -0,0 +1,87 @@
+#include <Vertica.h>
+#include "../../../include/datasketches/cpc/cpc_common.hpp"
+
+using namespace Vertica;
+
+class CpcSketchLBound : public CpcSketchScalarFunction {
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            // While we have inputs to process
+            do {
+                resWriter.setFloat(getSketch(argReader.getStringRef(0))->get_lower_bound(argReader.getIntRef(1)));
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class CpcSketchGetLBoundFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<CpcSketchLBound>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addInt();
+        returnType.addFloat();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+class CpcSketchUBound : public CpcSketchScalarFunction {
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            // While we have inputs to process
+            do {
+                resWriter.setFloat(getSketch(argReader.getStringRef(0))->get_upper_bound(argReader.getIntRef(1)));
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class CpcSketchGetUBoundFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<CpcSketchUBound>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addInt();
+        returnType.addFloat();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+RegisterFactory(CpcSketchGetLBoundFactory);
+RegisterFactory(CpcSketchGetUBoundFactory);
@@ -0,0 +1,29 @@
+#include <Vertica.h>
+#include <algorithm>
+#include "../../../include/datasketches/cpc/cpc_common.hpp"
+
+
+uint8_t readCpcLogK(ServerInterface &serverInterface) {
+    vint logK;
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME)) {
+        logK = paramReader.getIntRef(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME);
+        if (logK < DATASKETCHES_CPC_LOG_K_MIN || logK > DATASKETCHES_CPC_LOG_K_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, DATASKETCHES_CPC_LOG_K_MIN,
+                            DATASKETCHES_CPC_LOG_K_MAX);
+        }
+    } else {
+        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
+                        DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, DATASKETCHES_CPC_LOG_K_DEFAULT);
+        logK = DATASKETCHES_CPC_LOG_K_DEFAULT;
+    }
+    return logK;
+}
+
+uint32_t cpcSketchMaxSize(uint8_t logK) {
+    return std::min<size_t>(datasketches::cpc_sketch::get_max_serialized_size_bytes(logK),
+                            DATASKETCHES_CPC_MAX_SERIALIZED_SIZE);
+}
@@ -1,70 +1,78 @@
 #include "Vertica.h"
 #include <iostream>
-#include <thread>
-#include <frequent_items_sketch.hpp>
+#include <memory>
+#include <sstream>
+#include "../../../include/datasketches/frequency/frequency_common.hpp"
 
 using namespace Vertica;
 using namespace std;
 
-typedef datasketches::frequent_items_sketch<std::string> frequent_strings_sketch;
-
-uint8_t readTopK(ServerInterface &serverInterface) {
-    vint topK;
-    ParamReader paramReader = serverInterface.getParamReader();
-
-    if (paramReader.containsParameter("topK")) {
-        topK = paramReader.getIntRef("topK");
-        if (topK < 1 || topK > 1000000) {
-            vt_report_error(2,
-                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
-                            "topK", 1,
-                            1000000);
-        }
-    } else {
-        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
-                        "topK", 1000);
-        topK = 1000;
-    }
-    return topK;
-}
-
 /**
- * User Defined Aggregate Function concatenate that implements the frequent_items_sketch
+ * User Defined Aggregate Function that builds a frequent_items_sketch and returns it serialized.
  * Based on example from https://datasketches.apache.org/docs/Frequency/FrequentItemsCppExample.html
+ *
+ * The sketch stays live across the blocks of a group and is only serialized at the end of each block.
+ * Items reads the argument column and feeds the sketch.
  */
-class FrequencyAggregateCreate : public AggregateFunction {
+template<class Items>
+class FrequencyAggregateBuild : public FrequencySketchAggregateFunction<typename Items::sketch_type> {
 protected:
-    uint8_t topK;
+    typedef typename Items::sketch_type sketch_type;
 
-public:
-    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
-        this->topK = readTopK(srvInterface);
-    }
+    std::unique_ptr<sketch_type> sketch;
+    Items items;
 
+public:
     virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
         try {
-            frequent_strings_sketch updatex(topK);
-            auto data = updatex.serialize(); // provides compact & rebuild sketch <=> min size
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            sketch.reset(new sketch_type(frequencyLgMaxMapSize(this->topK)));
+            serializeFrequencySketch(*sketch, aggs.getStringRef(0)); // provides compact & rebuild sketch <=> min size
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
         }
     }
 
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                items.update(*sketch, argReader);
+            } while (argReader.next());
+            LogTrace(this->traceLevel, TRACE_VERBOSE, srvInterface, "frequency aggregate: %u active items",
+                     sketch->get_num_active_items());
+            serializeFrequencySketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+/**
+ * Same as FrequencyAggregateBuild, but returns the frequent items as a [[item,count],...] string.
+ */
+template<class Items>
+class FrequencyAggregateCreate : public FrequencyAggregateBuild<Items> {
+    typedef typename Items::sketch_type sketch_type;
+
+public:
     virtual void terminate(ServerInterface &srvInterface,
                            BlockWriter &resWriter,
                            IntermediateAggs &aggs) override {
         try {
-            const VString &concat = aggs.getStringRef(0);
             VString &result = resWriter.getStringRef();
-            frequent_strings_sketch u = frequent_strings_sketch::deserialize(aggs.getStringRef(0).data(),aggs.getStringRef(0).length());
-            auto items = u.get_frequent_items(datasketches::NO_FALSE_POSITIVES);
+            sketch_type u = deserializeFrequencySketch<sketch_type>(aggs.getStringRef(0).data(), aggs.getStringRef(0).length());
+            auto rows = u.get_frequent_items(datasketches::NO_FALSE_POSITIVES);
+            LogTrace(this->traceLevel, TRACE_INFO, srvInterface, "frequency terminate: %zu frequent items out of %u active",
+                     rows.size(), u.get_num_active_items());
             ostringstream os;
-            //os << "Frequent strings:" << items.size() << "|";
             os << "[";
             bool pastFirst = false;
-            for (auto row: items) {
+            for (auto row: rows) {
                 if (pastFirst) {
                     os << ",";
                 } else {
@@ -80,59 +88,22 @@ public:
         }
     }
 
-    void aggregate(ServerInterface &srvInterface,
-                   BlockReader &argReader,
-                   IntermediateAggs &aggs) {
-        try {
-            frequent_strings_sketch updatex = frequent_strings_sketch::deserialize(aggs.getStringRef(0).data(),aggs.getStringRef(0).length());
-            do {
-                updatex.update(argReader.getStringRef(0).str());
-            } while (argReader.next());
-            srvInterface.log("a:%d", updatex.get_frequent_items(datasketches::NO_FALSE_POSITIVES).size());
-            auto data = updatex.serialize();
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
-        } catch (exception &e) {
-            // Standard exception. Quit.
-            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
-        }
-    }
-
-    virtual void combine(ServerInterface &srvInterface,
-                         IntermediateAggs &aggs,
-                         MultipleIntermediateAggs &aggsOther) override {
-        try {
-            frequent_strings_sketch u = frequent_strings_sketch::deserialize(aggs.getStringRef(0).data(),aggs.getStringRef(0).length());
-            srvInterface.log("c:u:%d", u.get_frequent_items(datasketches::NO_FALSE_POSITIVES).size());
-
-            do {
-                frequent_strings_sketch um = frequent_strings_sketch::deserialize(aggsOther.getStringRef(0).data(),aggsOther.getStringRef(0).length());
-                srvInterface.log("c:um:%d", um.get_frequent_items(datasketches::NO_FALSE_POSITIVES).size());
-                u.merge(um);
-                srvInterface.log("c:merge:%d", u.get_frequent_items(datasketches::NO_FALSE_POSITIVES).size());
-            } while (aggsOther.next());
-
-            srvInterface.log("c:final:%d", u.get_frequent_items(datasketches::NO_FALSE_POSITIVES).size());
-            auto data = u.serialize();
-            aggs.getStringRef(0).copy((char *)&data[0], data.size());
-
-        } catch (exception &e) {
-            // Standard exception. Quit.
-            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
-        }
-    }
-
     InlineAggregate()
 };
 
-class FrequencyAggregateCreateFactory : public AggregateFunctionFactory {
+template<class Items>
+class FrequencyAggregateCreateFactoryBase : public FrequencySketchAggregateFunctionFactory {
     virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
-        argTypes.addVarchar();
+        Items::addArgumentType(argTypes);
         returnType.addLongVarchar();
     }
+
     virtual void getIntermediateTypes(ServerInterface &srvInterface,
                                       const SizedColumnTypes &inputTypes,
                                       SizedColumnTypes &intermediateTypeMetaData) {
-        intermediateTypeMetaData.addLongVarbinary(320000);
+        uint32_t topK = readTopK(srvInterface);
+        size_t maxItemSize = Items::maxItemSize(inputTypes.getColumnType(0));
+        intermediateTypeMetaData.addLongVarbinary(frequencySketchMaxSize(topK, maxItemSize));
     }
 
     virtual void getReturnType(ServerInterface &srvfloaterface,
@@ -141,18 +112,90 @@ class FrequencyAggregateCreateFactory : public AggregateFunctionFactory {
         outputTypes.addLongVarchar(500000);
     }
 
-    virtual void getParameterType(ServerInterface &srvInterface,
-                                  SizedColumnTypes &parameterTypes) {
-        SizedColumnTypes::Properties logNominalProps;
-        logNominalProps.required = false;
-        logNominalProps.canBeNull = false;
-        logNominalProps.comment = "Log Nominal value.";
-        parameterTypes.addInt("topK", logNominalProps);
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<FrequencyAggregateCreate<Items>>(srvInterface.allocator);
+    }
+};
+
+template<class Items>
+class FrequencyAggregateBuildFactoryBase : public FrequencySketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        Items::addArgumentType(argTypes);
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        uint32_t topK = readTopK(srvInterface);
+        size_t maxItemSize = Items::maxItemSize(inputTypes.getColumnType(0));
+        intermediateTypeMetaData.addLongVarbinary(frequencySketchMaxSize(topK, maxItemSize));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        uint32_t topK = readTopK(srvfloaterface);
+        size_t maxItemSize = Items::maxItemSize(inputTypes.getColumnType(0));
+        outputTypes.addLongVarbinary(frequencySketchMaxSize(topK, maxItemSize));
     }
 
     virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
-        return vt_createFuncObject<FrequencyAggregateCreate>(srvInterface.allocator);
+        return vt_createFuncObject<FrequencyAggregateBuild<Items>>(srvInterface.allocator);
     }
 };
 
+class FrequencyAggregateCreateFactory : public FrequencyAggregateCreateFactoryBase<FrequencyVarcharItems> {
+};
+
+class FrequencyAggregateCreateIntFactory : public FrequencyAggregateCreateFactoryBase<FrequencyIntItems> {
+};
+
+class FrequencyAggregateCreateUuidFactory : public FrequencyAggregateCreateFactoryBase<FrequencyUuidItems> {
+};
+
+class FrequencyAggregateCreateWeightedFactory
+        : public FrequencyAggregateCreateFactoryBase<FrequencyWeighted<FrequencyVarcharItems>> {
+};
+
+class FrequencyAggregateCreateWeightedIntFactory
+        : public FrequencyAggregateCreateFactoryBase<FrequencyWeighted<FrequencyIntItems>> {
+};
+
+class FrequencyAggregateCreateWeightedUuidFactory
+        : public FrequencyAggregateCreateFactoryBase<FrequencyWeighted<FrequencyUuidItems>> {
+};
+
+class FrequencyAggregateBuildVarcharFactory : public FrequencyAggregateBuildFactoryBase<FrequencyVarcharItems> {
+};
+
+class FrequencyAggregateBuildIntFactory : public FrequencyAggregateBuildFactoryBase<FrequencyIntItems> {
+};
+
+class FrequencyAggregateBuildUuidFactory : public FrequencyAggregateBuildFactoryBase<FrequencyUuidItems> {
+};
+
+class FrequencyAggregateBuildWeightedVarcharFactory
+        : public FrequencyAggregateBuildFactoryBase<FrequencyWeighted<FrequencyVarcharItems>> {
+};
+
+class FrequencyAggregateBuildWeightedIntFactory
+        : public FrequencyAggregateBuildFactoryBase<FrequencyWeighted<FrequencyIntItems>> {
+};
+
+class FrequencyAggregateBuildWeightedUuidFactory
+        : public FrequencyAggregateBuildFactoryBase<FrequencyWeighted<FrequencyUuidItems>> {
+};
+
 RegisterFactory(FrequencyAggregateCreateFactory);
+RegisterFactory(FrequencyAggregateCreateIntFactory);
+RegisterFactory(FrequencyAggregateCreateUuidFactory);
+RegisterFactory(FrequencyAggregateCreateWeightedFactory);
+RegisterFactory(FrequencyAggregateCreateWeightedIntFactory);
+RegisterFactory(FrequencyAggregateCreateWeightedUuidFactory);
+RegisterFactory(FrequencyAggregateBuildVarcharFactory);
+RegisterFactory(FrequencyAggregateBuildIntFactory);
+RegisterFactory(FrequencyAggregateBuildUuidFactory);
+RegisterFactory(FrequencyAggregateBuildWeightedVarcharFactory);
+RegisterFactory(FrequencyAggregateBuildWeightedIntFactory);
+RegisterFactory(FrequencyAggregateBuildWeightedUuidFactory);
@@ -0,0 +1,71 @@
+#include "Vertica.h"
+#include <iostream>
+#include "../../../include/datasketches/frequency/frequency_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function merging serialized frequent_items_sketch, as returned by frequency_sketch_build.
+ */
+template<class Items>
+class FrequencyAggregateUnion : public FrequencySketchAggregateFunction<typename Items::sketch_type> {
+    typedef typename Items::sketch_type sketch_type;
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            sketch_type u = deserializeFrequencySketch<sketch_type>(aggs.getStringRef(0).data(), aggs.getStringRef(0).length());
+            do {
+                const VString &sketch = argReader.getStringRef(0);
+                if (!sketch.isNull()) {
+                    u.merge(deserializeFrequencySketch<sketch_type>(sketch.data(), sketch.length()));
+                }
+            } while (argReader.next());
+            serializeFrequencySketch(u, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+template<class Items>
+class FrequencyAggregateUnionFactoryBase : public FrequencySketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        intermediateTypeMetaData.addLongVarbinary(frequencyMergedSketchMaxSize<Items>(readTopK(srvInterface)));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(frequencyMergedSketchMaxSize<Items>(readTopK(srvfloaterface)));
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<FrequencyAggregateUnion<Items>>(srvInterface.allocator);
+    }
+};
+
+class FrequencyAggregateUnionVarcharFactory : public FrequencyAggregateUnionFactoryBase<FrequencyVarcharItems> {
+};
+
+class FrequencyAggregateUnionIntFactory : public FrequencyAggregateUnionFactoryBase<FrequencyIntItems> {
+};
+
+class FrequencyAggregateUnionUuidFactory : public FrequencyAggregateUnionFactoryBase<FrequencyUuidItems> {
+};
+
+RegisterFactory(FrequencyAggregateUnionVarcharFactory);
+RegisterFactory(FrequencyAggregateUnionIntFactory);
+RegisterFactory(FrequencyAggregateUnionUuidFactory);
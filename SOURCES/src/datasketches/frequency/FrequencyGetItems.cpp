@@ -0,0 +1,124 @@
+#include "Vertica.h"
+#include <iostream>
+#include <memory>
+#include "../../../include/datasketches/frequency/frequency_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Transform Function returning one (item, estimate, lower_bound, upper_bound) row per frequent item
+ * of the serialized sketches of a partition, by decreasing estimate. Sketches of the same partition are merged first.
+ */
+template<class Items>
+class FrequencyGetItems : public TransformFunction {
+    typedef typename Items::sketch_type sketch_type;
+
+protected:
+    datasketches::frequent_items_error_type errorType;
+    vint limit;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->errorType = readErrorType(srvInterface);
+        this->limit = readLimit(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  PartitionReader &inputReader,
+                                  PartitionWriter &outputWriter) {
+        try {
+            std::unique_ptr<sketch_type> u;
+            do {
+                const VString &sketch = inputReader.getStringRef(0);
+                if (sketch.isNull()) {
+                    continue;
+                }
+                if (u) {
+                    u->merge(deserializeFrequencySketch<sketch_type>(sketch.data(), sketch.length()));
+                } else {
+                    u.reset(new sketch_type(deserializeFrequencySketch<sketch_type>(sketch.data(), sketch.length())));
+                }
+            } while (inputReader.next() && !isCanceled());
+
+            if (!u) {
+                return;
+            }
+            auto rows = u->get_frequent_items(errorType);
+            LogTrace(traceLevel, TRACE_INFO, srvInterface, "frequency items: %zu frequent items out of %u active",
+                     rows.size(), u->get_num_active_items());
+
+            vint emitted = 0;
+            for (auto &row: rows) {
+                if (limit > 0 && emitted >= limit) {
+                    break;
+                }
+                Items::setOutput(outputWriter, 0, row.get_item());
+                outputWriter.setInt(1, row.get_estimate());
+                outputWriter.setInt(2, row.get_lower_bound());
+                outputWriter.setInt(3, row.get_upper_bound());
+                outputWriter.next();
+                emitted++;
+            }
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+};
+
+template<class Items>
+class FrequencyGetItemsFactoryBase : public TransformFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addAny();
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        if (inputTypes.getColumnCount() != 1)
+            vt_report_error(0, "Function only accepts 1 argument, but %zu provided", inputTypes.getColumnCount());
+
+        Items::addOutputType(outputTypes, "item");
+        outputTypes.addInt("estimate");
+        outputTypes.addInt("lower_bound");
+        outputTypes.addInt("upper_bound");
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties errorTypeProps;
+        errorTypeProps.required = false;
+        errorTypeProps.canBeNull = false;
+        errorTypeProps.comment = "NO_FALSE_POSITIVES (default) or NO_FALSE_NEGATIVES.";
+        parameterTypes.addVarchar(32, DATASKETCHES_ERROR_TYPE_PARAMETER_NAME, errorTypeProps);
+
+        SizedColumnTypes::Properties limitProps;
+        limitProps.required = false;
+        limitProps.canBeNull = false;
+        limitProps.comment = "Maximum number of rows returned, all frequent items by default.";
+        parameterTypes.addInt(DATASKETCHES_LIMIT_PARAMETER_NAME, limitProps);
+
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual TransformFunction *createTransformFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<FrequencyGetItems<Items>>(srvInterface.allocator);
+    }
+};
+
+class FrequencyGetItemsVarcharFactory : public FrequencyGetItemsFactoryBase<FrequencyVarcharItems> {
+};
+
+class FrequencyGetItemsIntFactory : public FrequencyGetItemsFactoryBase<FrequencyIntItems> {
+};
+
+class FrequencyGetItemsUuidFactory : public FrequencyGetItemsFactoryBase<FrequencyUuidItems> {
+};
+
+RegisterFactory(FrequencyGetItemsVarcharFactory);
+RegisterFactory(FrequencyGetItemsIntFactory);
+RegisterFactory(FrequencyGetItemsUuidFactory);
@@ -0,0 +1,70 @@
+#include <Vertica.h>
+#include <algorithm>
+#include "../../../include/datasketches/frequency/frequency_common.hpp"
+
+
+uint32_t readTopK(ServerInterface &serverInterface) {
+    vint topK;
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_TOP_K_PARAMETER_NAME)) {
+        topK = paramReader.getIntRef(DATASKETCHES_TOP_K_PARAMETER_NAME);
+        if (topK < DATASKETCHES_TOP_K_MIN || topK > DATASKETCHES_TOP_K_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_TOP_K_PARAMETER_NAME, DATASKETCHES_TOP_K_MIN,
+                            DATASKETCHES_TOP_K_MAX);
+        }
+    } else {
+        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
+                        DATASKETCHES_TOP_K_PARAMETER_NAME, DATASKETCHES_TOP_K_DEFAULT);
+        topK = DATASKETCHES_TOP_K_DEFAULT;
+    }
+    return topK;
+}
+
+datasketches::frequent_items_error_type readErrorType(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_ERROR_TYPE_PARAMETER_NAME)) {
+        std::string errorType = paramReader.getStringRef(DATASKETCHES_ERROR_TYPE_PARAMETER_NAME).str();
+        if (errorType == "NO_FALSE_POSITIVES") {
+            return datasketches::NO_FALSE_POSITIVES;
+        }
+        if (errorType == "NO_FALSE_NEGATIVES") {
+            return datasketches::NO_FALSE_NEGATIVES;
+        }
+        vt_report_error(2,
+                        "Provided value of the %s parameter is not supported. The value should be NO_FALSE_POSITIVES or NO_FALSE_NEGATIVES",
+                        DATASKETCHES_ERROR_TYPE_PARAMETER_NAME);
+    }
+    return datasketches::NO_FALSE_POSITIVES;
+}
+
+vint readLimit(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_LIMIT_PARAMETER_NAME)) {
+        vint limit = paramReader.getIntRef(DATASKETCHES_LIMIT_PARAMETER_NAME);
+        if (limit < 0) {
+            vt_report_error(2, "Provided value of the %s parameter is not supported. The value should be positive",
+                            DATASKETCHES_LIMIT_PARAMETER_NAME);
+        }
+        return limit;
+    }
+    return 0;
+}
+
+uint8_t frequencyLgMaxMapSize(uint32_t topK) {
+    uint8_t lgMaxMapSize = DATASKETCHES_FREQUENCY_LG_MIN_MAP_SIZE;
+    while ((3ULL << lgMaxMapSize) / 4 < topK) {
+        lgMaxMapSize++;
+    }
+    return lgMaxMapSize;
+}
+
+uint32_t frequencySketchMaxSize(uint32_t topK, size_t maxItemSize) {
+    const uint64_t maxItems = (3ULL << frequencyLgMaxMapSize(topK)) / 4;
+    const uint64_t size = 6 * sizeof(uint64_t) + maxItems * (sizeof(uint64_t) + maxItemSize);
+    return std::min<uint64_t>(size, DATASKETCHES_FREQUENCY_MAX_SERIALIZED_SIZE);
+}
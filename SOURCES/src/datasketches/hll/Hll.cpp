@@ -3,6 +3,7 @@
 #include <thread>
 #include <hll.hpp>
 #include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/hll/hll_common.hpp"
 
 using namespace Vertica;
 using namespace std;
@@ -16,18 +17,19 @@ uint8_t readLogK(ServerInterface &serverInterface);
 class HllAggregateCreate : public AggregateFunction {
 protected:
   int logK = 11;
+  uint8_t traceLevel = TRACE_OFF;
   datasketches::target_hll_type type = datasketches::HLL_4;
 
 public:
     virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
         this->logK = readLogK(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
     }
 
     virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
         try {
             datasketches::hll_sketch sketch1(logK, type);
-            auto data = sketch1.serialize_compact(); // provides compact & rebuild sketch <=> min size
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            serializeHllSketch(sketch1, aggs.getStringRef(0)); // provides compact & rebuild sketch <=> min size
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
@@ -58,8 +60,7 @@ public:
                 sketch2.update(argReader.getStringRef(0).str());
             } while (argReader.next());
             u.update(sketch2);
-            auto data = u.get_result().serialize_compact();
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            serializeHllSketch(u.get_result(), aggs.getStringRef(0));
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
@@ -73,13 +74,15 @@ public:
             datasketches::hll_union u(logK);
             datasketches::hll_sketch sketch1 = datasketches::hll_sketch::deserialize(aggs.getStringRef(0).data(),aggs.getStringRef(0).length());
             u.update(sketch1);
+            int merged = 0;
             do {
                 datasketches::hll_sketch sketch2 = datasketches::hll_sketch::deserialize(aggsOther.getStringRef(0).data(),aggsOther.getStringRef(0).length());
                 u.update(sketch2);
+                merged++;
             } while (aggsOther.next());
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "hll combine: merged %d sketches", merged);
 
-            auto data = u.get_result().serialize_compact();
-            aggs.getStringRef(0).copy((char *)&data[0], data.size());
+            serializeHllSketch(u.get_result(), aggs.getStringRef(0));
 
         } catch (exception &e) {
             // Standard exception. Quit.
@@ -90,6 +93,38 @@ public:
     InlineAggregate()
 };
 
+/**
+ * hll_sketch_create_from_hash(hash): same as hll_sketch_create over a theta_hash column. HLL sketches only take
+ * values, and their coupons need the 128 bits of the MurmurHash3 of a value while theta_hash keeps 63 of them, so
+ * hashes are sketched as 8 bytes values: no string handling and a short fixed size hash, but the estimates do not
+ * mix with those of the original values.
+ */
+class HllAggregateCreateFromHash : public HllAggregateCreate {
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            datasketches::hll_union u(logK);
+            datasketches::hll_sketch sketch1 = datasketches::hll_sketch::deserialize(aggs.getStringRef(0).data(),aggs.getStringRef(0).length());
+            u.update(sketch1);
+            datasketches::hll_sketch sketch2(logK, type);
+            do {
+                const vint hash = argReader.getIntRef(0);
+                if (hash != vint_null) {
+                    sketch2.update(static_cast<int64_t>(hash));
+                }
+            } while (argReader.next());
+            u.update(sketch2);
+            serializeHllSketch(u.get_result(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
 class HllAggregateCreateFactory : public AggregateFunctionFactory {
     virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
         argTypes.addVarchar();
@@ -114,6 +149,8 @@ class HllAggregateCreateFactory : public AggregateFunctionFactory {
         logNominalProps.canBeNull = false;
         logNominalProps.comment = "Log Nominal value.";
         parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addTraceLevelParameter(parameterTypes);
     }
 
     virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
@@ -121,4 +158,16 @@ class HllAggregateCreateFactory : public AggregateFunctionFactory {
     }
 };
 
+class HllAggregateCreateFromHashFactory : public HllAggregateCreateFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addInt();
+        returnType.addInt();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<HllAggregateCreateFromHash>(srvInterface.allocator);
+    }
+};
+
 RegisterFactory(HllAggregateCreateFactory);
+RegisterFactory(HllAggregateCreateFromHashFactory);
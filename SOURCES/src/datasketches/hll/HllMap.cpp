@@ -0,0 +1,149 @@
+#include "Vertica.h"
+#include <iostream>
+#include "../../../include/datasketches/hll/hll_map.hpp"
+#include "../../../include/datasketches/trace.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * Column policies reading a key or value column as bytes, and writing keys back.
+ */
+struct HllMapVarcharColumn {
+    const void *data;
+    size_t length;
+
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addVarchar();
+    }
+
+    static void addOutputType(const VerticaType &inputType, SizedColumnTypes &outputTypes) {
+        outputTypes.addVarchar(inputType.getStringLength(), "key");
+    }
+
+    bool read(PartitionReader &inputReader, size_t column) {
+        const VString &value = inputReader.getStringRef(column);
+        if (value.isNull()) {
+            return false;
+        }
+        data = value.data();
+        length = value.length();
+        return true;
+    }
+
+    static void write(PartitionWriter &outputWriter, size_t column, const char *key, size_t keyLength) {
+        outputWriter.getStringRef(column).copy(key, keyLength);
+    }
+};
+
+struct HllMapIntColumn {
+    vint value;
+    const void *data = &value;
+    size_t length = sizeof(value);
+
+    static void addArgumentType(ColumnTypes &argTypes) {
+        argTypes.addInt();
+    }
+
+    static void addOutputType(const VerticaType &inputType, SizedColumnTypes &outputTypes) {
+        outputTypes.addInt("key");
+    }
+
+    bool read(PartitionReader &inputReader, size_t column) {
+        value = inputReader.getIntRef(column);
+        return value != vint_null;
+    }
+
+    static void write(PartitionWriter &outputWriter, size_t column, const char *key, size_t keyLength) {
+        vint value;
+        std::memcpy(&value, key, sizeof(value));
+        outputWriter.setInt(column, value);
+    }
+};
+
+/**
+ * User Defined Transform Function counting distinct values per key for every key of a partition at once,
+ * with an hll_map rather than one sketch per key. Emits one (key, estimate) row per key.
+ */
+template<class Key, class Value>
+class HllMapUDTF : public TransformFunction {
+protected:
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  PartitionReader &inputReader,
+                                  PartitionWriter &outputWriter) {
+        try {
+            hll_map map;
+            Key key;
+            Value value;
+            do {
+                if (key.read(inputReader, 0) && value.read(inputReader, 1)) {
+                    map.update(key.data, key.length, value.data, value.length);
+                }
+            } while (inputReader.next() && !isCanceled());
+
+            LogTrace(traceLevel, TRACE_INFO, srvInterface, "hll map: %zu keys in %zu bytes",
+                     map.getNumKeys(), map.getMemoryUsage());
+
+            map.forEach([&outputWriter](const char *k, size_t keyLength, double estimate) {
+                Key::write(outputWriter, 0, k, keyLength);
+                outputWriter.setFloat(1, estimate);
+                outputWriter.next();
+            });
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+};
+
+template<class Key, class Value>
+class HllMapUDTFFactoryBase : public TransformFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        Key::addArgumentType(argTypes);
+        Value::addArgumentType(argTypes);
+        returnType.addAny();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        if (inputTypes.getColumnCount() != 2)
+            vt_report_error(0, "Function only accepts 2 arguments, but %zu provided", inputTypes.getColumnCount());
+
+        Key::addOutputType(inputTypes.getColumnType(0), outputTypes);
+        outputTypes.addFloat("estimate");
+    }
+
+    virtual TransformFunction *createTransformFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<HllMapUDTF<Key, Value>>(srvInterface.allocator);
+    }
+};
+
+class HllMapVarcharVarcharFactory : public HllMapUDTFFactoryBase<HllMapVarcharColumn, HllMapVarcharColumn> {
+};
+
+class HllMapVarcharIntFactory : public HllMapUDTFFactoryBase<HllMapVarcharColumn, HllMapIntColumn> {
+};
+
+class HllMapIntVarcharFactory : public HllMapUDTFFactoryBase<HllMapIntColumn, HllMapVarcharColumn> {
+};
+
+class HllMapIntIntFactory : public HllMapUDTFFactoryBase<HllMapIntColumn, HllMapIntColumn> {
+};
+
+RegisterFactory(HllMapVarcharVarcharFactory);
+RegisterFactory(HllMapVarcharIntFactory);
+RegisterFactory(HllMapIntVarcharFactory);
+RegisterFactory(HllMapIntIntFactory);
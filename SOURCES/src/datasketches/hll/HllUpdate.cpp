@@ -0,0 +1,197 @@
+#include "Vertica.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <hll.hpp>
+#include "../../../include/datasketches/hll/hll_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * hll_sketch_update(base_sketch, value): base_sketch with the values of the group added, as a serialized HLL
+ * sketch, for adding new rows to a stored cumulative sketch. HLL sketches stay updatable once deserialized, so the
+ * first non NULL base_sketch of a group becomes the live sketch the values go to, and no union is needed unless
+ * values came first. base_sketch is expected to be the same for every row of a group, later values are ignored.
+ */
+class HllAggregateUpdate : public AggregateFunction {
+protected:
+    uint8_t logK;
+    uint8_t traceLevel;
+    bool hasBase;
+    std::unique_ptr<datasketches::hll_sketch> sketch;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->logK = readHllLogK(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            hasBase = false;
+            sketch.reset(new datasketches::hll_sketch(logK, datasketches::HLL_4));
+            serializeHllSketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                if (!hasBase) {
+                    const VString &bytes = argReader.getStringRef(0);
+                    if (!bytes.isNull()) {
+                        datasketches::hll_sketch base = datasketches::hll_sketch::deserialize(bytes.data(), bytes.length());
+                        if (sketch->is_empty()) {
+                            sketch.reset(new datasketches::hll_sketch(std::move(base)));
+                        } else {
+                            datasketches::hll_union u(std::max(logK, base.get_lg_config_k()));
+                            u.update(base);
+                            u.update(*sketch);
+                            sketch.reset(new datasketches::hll_sketch(u.get_result(base.get_target_type())));
+                        }
+                        hasBase = true;
+                    }
+                }
+                const VString &value = argReader.getStringRef(1);
+                if (!value.isNull() && value.length() > 0) {
+                    sketch->update(value.data(), value.length());
+                }
+            } while (argReader.next());
+            serializeHllSketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            std::vector<datasketches::hll_sketch> partials;
+            partials.push_back(datasketches::hll_sketch::deserialize(aggs.getStringRef(0).data(),
+                                                                     aggs.getStringRef(0).length()));
+            do {
+                partials.push_back(datasketches::hll_sketch::deserialize(aggsOther.getStringRef(0).data(),
+                                                                         aggsOther.getStringRef(0).length()));
+            } while (aggsOther.next());
+
+            // Partials without a base are HLL_4 sketches of logK, the one holding the base has its lgK and type.
+            uint8_t lgK = logK;
+            datasketches::target_hll_type type = datasketches::HLL_4;
+            for (const datasketches::hll_sketch &partial: partials) {
+                lgK = std::max(lgK, partial.get_lg_config_k());
+                if (partial.get_target_type() != datasketches::HLL_4) {
+                    type = partial.get_target_type();
+                }
+            }
+            datasketches::hll_union u(lgK);
+            for (const datasketches::hll_sketch &partial: partials) {
+                u.update(partial);
+            }
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "hll update combine: merged %d sketches",
+                     (int) partials.size() - 1);
+
+            serializeHllSketch(u.get_result(type), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    virtual void terminate(ServerInterface &srvInterface,
+                           BlockWriter &resWriter,
+                           IntermediateAggs &aggs) override {
+        try {
+            resWriter.getStringRef().copy(&aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while computing aggregate output: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class HllAggregateUpdateFactory : public AggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addVarchar();
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        intermediateTypeMetaData.addLongVarbinary(hllSketchMaxSize(DATASKETCHES_HLL_LOG_K_MAX));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(hllSketchMaxSize(DATASKETCHES_HLL_LOG_K_MAX));
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value of the sketch created when there is no base sketch.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<HllAggregateUpdate>(srvInterface.allocator);
+    }
+};
+
+/**
+ * hll_sketch_get_estimate(sketch): distinct count estimate of a serialized HLL sketch, as an integer as
+ * hll_sketch_create returns it.
+ */
+class HllSketchGetEstimate : public ScalarFunction {
+public:
+    virtual void processBlock(ServerInterface &srvInterface,
+                              BlockReader &argReader,
+                              BlockWriter &resWriter) {
+        try {
+            do {
+                const VString &bytes = argReader.getStringRef(0);
+                if (bytes.isNull()) {
+                    resWriter.setInt(vint_null);
+                } else {
+                    resWriter.setInt(datasketches::hll_sketch::deserialize(bytes.data(), bytes.length()).get_estimate());
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class HllSketchGetEstimateFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<HllSketchGetEstimate>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addInt();
+    }
+};
+
+RegisterFactory(HllAggregateUpdateFactory);
+RegisterFactory(HllSketchGetEstimateFactory);
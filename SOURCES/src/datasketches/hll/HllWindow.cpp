@@ -0,0 +1,84 @@
+#include "Vertica.h"
+#include <memory>
+#include <hll.hpp>
+#include "../../../include/datasketches/hll/hll_common.hpp"
+#include "../../../include/datasketches/window_analytic.hpp"
+
+using namespace Vertica;
+
+/**
+ * hll_sketch_window_estimate(value): panes are HLL sketches of their values, the result is the window estimate.
+ * Panes and unions are kept as HLL_8, the type hll_union works in, so that combining them does not convert.
+ */
+class HllWindowValues {
+public:
+    typedef datasketches::hll_sketch value_type;
+
+    void setup(ServerInterface &srvInterface) {
+        this->logK = readHllLogK(srvInterface);
+        newPane();
+    }
+
+    value_type combine(const value_type &older, const value_type &newer) const {
+        datasketches::hll_union u(logK);
+        u.update(older);
+        u.update(newer);
+        return u.get_result(datasketches::HLL_8);
+    }
+
+    void add(AnalyticPartitionReader &inputReader) {
+        const VString &value = inputReader.getStringRef(0);
+        if (!value.isNull() && value.length() > 0) {
+            pane->update(value.data(), value.length());
+        }
+    }
+
+    value_type takePane() {
+        value_type result(std::move(*pane));
+        newPane();
+        return result;
+    }
+
+    void write(AnalyticPartitionWriter &outputWriter, const value_type &result) const {
+        outputWriter.setInt(0, result.get_estimate());
+    }
+
+private:
+    uint8_t logK;
+    std::unique_ptr<value_type> pane;
+
+    void newPane() {
+        pane.reset(new value_type(logK, datasketches::HLL_8));
+    }
+};
+
+class HllWindowEstimateFactory : public AnalyticFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addVarchar();
+        returnType.addInt();
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addInt();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addWindowParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual AnalyticFunction *createAnalyticFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<SlidingWindowAnalytic<HllWindowValues>>(srvInterface.allocator);
+    }
+};
+
+RegisterFactory(HllWindowEstimateFactory);
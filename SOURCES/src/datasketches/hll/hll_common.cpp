@@ -0,0 +1,40 @@
+#include <Vertica.h>
+#include <algorithm>
+#include "../../../include/datasketches/hll/hll_common.hpp"
+#include "../../../include/datasketches/serialize.hpp"
+
+
+uint8_t readHllLogK(ServerInterface &serverInterface) {
+    vint logK;
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME)) {
+        logK = paramReader.getIntRef(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME);
+        if (logK < DATASKETCHES_HLL_LOG_K_MIN || logK > DATASKETCHES_HLL_LOG_K_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, DATASKETCHES_HLL_LOG_K_MIN,
+                            DATASKETCHES_HLL_LOG_K_MAX);
+        }
+    } else {
+        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
+                        DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, DATASKETCHES_HLL_LOG_K_DEFAULT);
+        logK = DATASKETCHES_HLL_LOG_K_DEFAULT;
+    }
+    return logK;
+}
+
+uint32_t hllSketchMaxSize(uint8_t logK) {
+    // Compact serializations are never larger than updatable ones, HLL_4 ones hold an exception table.
+    size_t size = 0;
+    for (const datasketches::target_hll_type type: {datasketches::HLL_4, datasketches::HLL_6, datasketches::HLL_8}) {
+        size = std::max<size_t>(size, datasketches::hll_sketch::get_max_updatable_serialization_bytes(logK, type));
+    }
+    return std::min<size_t>(size, DATASKETCHES_HLL_MAX_SERIALIZED_SIZE);
+}
+
+void serializeHllSketch(const datasketches::hll_sketch &sketch, VString &out) {
+    serializeToVString(out, sketch.get_compact_serialization_bytes(), [&sketch](std::ostream &os) {
+        sketch.serialize_compact(os);
+    });
+}
@@ -0,0 +1,272 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <MurmurHash3.h>
+#include "../../../include/datasketches/hll/hll_map.hpp"
+
+// Same seed and coupon layout as datasketches HLL sketches.
+static const uint64_t HLL_MAP_HASH_SEED = 9001;
+static const uint32_t KEY_MASK_26 = (1U << 26) - 1;
+static const uint32_t HLL_K = 1U << hll_map::LG_HLL_K;
+
+hll_map::hll_map(uint8_t lgInitialSize) : lgSize(lgInitialSize), numKeys(0), entries(1ULL << lgInitialSize) {
+}
+
+uint32_t hll_map::coupon(const void *value, size_t valueLength) {
+    HashState hashes;
+    MurmurHash3_x64_128(value, valueLength, HLL_MAP_HASH_SEED, hashes);
+    const uint32_t address = static_cast<uint32_t>(hashes.h1) & KEY_MASK_26;
+    const uint8_t leadingZeros = hashes.h2 == 0 ? 64 : __builtin_clzll(hashes.h2);
+    const uint32_t couponValue = (leadingZeros > 62 ? 62 : leadingZeros) + 1;
+    return (couponValue << 26) | address;
+}
+
+uint32_t hll_map::fingerprint(const void *key, size_t keyLength) {
+    HashState hashes;
+    MurmurHash3_x64_128(key, keyLength, 0, hashes);
+    return static_cast<uint32_t>(hashes.h1);
+}
+
+void hll_map::update(const void *key, size_t keyLength, const void *value, size_t valueLength) {
+    if (valueLength == 0) {
+        return;
+    }
+    updateCoupon(key, keyLength, coupon(value, valueLength));
+}
+
+size_t hll_map::find(uint32_t fingerprint, const void *key, size_t keyLength) const {
+    const size_t mask = entries.size() - 1;
+    size_t index = fingerprint & mask;
+    while (true) {
+        const Entry &entry = entries[index];
+        if (entry.stage == EMPTY) {
+            return index;
+        }
+        if (entry.fingerprint == fingerprint && entry.keyLength == keyLength
+            && (keyLength == 0 || std::memcmp(keys.data() + entry.keyOffset, key, keyLength) == 0)) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+void hll_map::grow() {
+    std::vector<Entry> previous(entries.size() * 2);
+    previous.swap(entries);
+    lgSize++;
+    const size_t mask = entries.size() - 1;
+    for (const Entry &entry: previous) {
+        if (entry.stage == EMPTY) {
+            continue;
+        }
+        size_t index = entry.fingerprint & mask;
+        while (entries[index].stage != EMPTY) {
+            index = (index + 1) & mask;
+        }
+        entries[index] = entry;
+    }
+}
+
+hll_map::Entry &hll_map::findOrInsert(const void *key, size_t keyLength) {
+    const uint32_t keyFingerprint = fingerprint(key, keyLength);
+    size_t index = find(keyFingerprint, key, keyLength);
+    if (entries[index].stage != EMPTY) {
+        return entries[index];
+    }
+
+    if (keyLength > std::numeric_limits<uint16_t>::max()) {
+        throw std::length_error("hll_map keys are limited to 65535 bytes");
+    }
+    if (keys.size() + keyLength > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("hll_map keys are limited to 4GB in total");
+    }
+    if (4 * (numKeys + 1) > 3 * entries.size()) {
+        grow();
+        index = find(keyFingerprint, key, keyLength);
+    }
+
+    Entry &entry = entries[index];
+    entry.fingerprint = keyFingerprint;
+    entry.keyOffset = static_cast<uint32_t>(keys.size());
+    entry.keyLength = static_cast<uint16_t>(keyLength);
+    entry.stage = INLINE;
+    entry.lgSetSize = 0;
+    entry.count = 0;
+    keys.insert(keys.end(), static_cast<const char *>(key), static_cast<const char *>(key) + keyLength);
+    numKeys++;
+    return entry;
+}
+
+uint32_t hll_map::allocateSet(uint8_t lgSetSize) {
+    const size_t setSize = 1ULL << lgSetSize;
+    std::vector<uint32_t> &freeList = freeSets[lgSetSize];
+    if (!freeList.empty()) {
+        uint32_t offset = freeList.back();
+        freeList.pop_back();
+        std::memset(couponSets.data() + offset, 0, setSize * sizeof(uint32_t));
+        return offset;
+    }
+    if (couponSets.size() + setSize > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("hll_map coupon arena is full");
+    }
+    uint32_t offset = static_cast<uint32_t>(couponSets.size());
+    couponSets.resize(couponSets.size() + setSize, 0);
+    return offset;
+}
+
+void hll_map::releaseSet(uint32_t offset, uint8_t lgSetSize) {
+    freeSets[lgSetSize].push_back(offset);
+}
+
+bool hll_map::insertInSet(uint32_t *set, uint8_t lgSetSize, uint32_t coupon) {
+    const uint32_t mask = (1U << lgSetSize) - 1;
+    uint32_t index = (coupon * 0x9E3779B1U) >> (32 - lgSetSize);
+    while (true) {
+        if (set[index] == 0) {
+            set[index] = coupon;
+            return true;
+        }
+        if (set[index] == coupon) {
+            return false;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+void hll_map::addToSet(Entry &entry, uint32_t coupon) {
+    if (!insertInSet(&couponSets[entry.slots[0]], entry.lgSetSize, coupon)) {
+        return;
+    }
+    entry.count++;
+    const uint32_t setSize = 1U << entry.lgSetSize;
+    if (4 * entry.count <= 3 * setSize) {
+        return;
+    }
+
+    const uint32_t previousOffset = entry.slots[0];
+    const uint8_t previousLgSetSize = entry.lgSetSize;
+    if (entry.lgSetSize == LG_MAX_SET_SIZE) {
+        std::vector<uint32_t> coupons;
+        coupons.reserve(entry.count);
+        for (uint32_t i = 0; i < setSize; i++) {
+            if (couponSets[previousOffset + i] != 0) {
+                coupons.push_back(couponSets[previousOffset + i]);
+            }
+        }
+        promoteToHll(entry, coupons.data(), static_cast<uint32_t>(coupons.size()));
+    } else {
+        const uint32_t offset = allocateSet(previousLgSetSize + 1);
+        for (uint32_t i = 0; i < setSize; i++) {
+            const uint32_t previous = couponSets[previousOffset + i];
+            if (previous != 0) {
+                insertInSet(&couponSets[offset], previousLgSetSize + 1, previous);
+            }
+        }
+        entry.slots[0] = offset;
+        entry.lgSetSize = previousLgSetSize + 1;
+    }
+    releaseSet(previousOffset, previousLgSetSize);
+}
+
+void hll_map::promoteToHll(Entry &entry, const uint32_t *coupons, uint32_t numCoupons) {
+    const size_t hllIndex = registers.size() / HLL_K;
+    if (hllIndex > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("hll_map register arena is full");
+    }
+    registers.resize(registers.size() + HLL_K, 0);
+    uint8_t *hll = &registers[hllIndex * HLL_K];
+    for (uint32_t i = 0; i < numCoupons; i++) {
+        const uint32_t slot = coupons[i] & (HLL_K - 1);
+        const uint8_t value = coupons[i] >> 26;
+        if (value > hll[slot]) {
+            hll[slot] = value;
+        }
+    }
+    double kxq = 0;
+    for (uint32_t slot = 0; slot < HLL_K; slot++) {
+        kxq += std::ldexp(1.0, -hll[slot]);
+    }
+    // The coupons seen so far give the count, the HIP estimator takes over from there.
+    hipStates.push_back(numCoupons);
+    hipStates.push_back(kxq);
+
+    entry.stage = HLL;
+    entry.lgSetSize = 0;
+    entry.slots[0] = static_cast<uint32_t>(hllIndex);
+}
+
+void hll_map::addToHll(uint32_t hllIndex, uint32_t coupon) {
+    uint8_t &reg = registers[static_cast<size_t>(hllIndex) * HLL_K + (coupon & (HLL_K - 1))];
+    const uint8_t value = coupon >> 26;
+    if (value <= reg) {
+        return;
+    }
+    double &hipEstimate = hipStates[2 * static_cast<size_t>(hllIndex)];
+    double &kxq = hipStates[2 * static_cast<size_t>(hllIndex) + 1];
+    hipEstimate += HLL_K / kxq;
+    kxq -= std::ldexp(1.0, -reg);
+    kxq += std::ldexp(1.0, -value);
+    reg = value;
+}
+
+void hll_map::updateCoupon(const void *key, size_t keyLength, uint32_t coupon) {
+    Entry &entry = findOrInsert(key, keyLength);
+    switch (entry.stage) {
+        case INLINE: {
+            for (uint32_t i = 0; i < entry.count; i++) {
+                if (entry.slots[i] == coupon) {
+                    return;
+                }
+            }
+            if (entry.count < INLINE_COUPONS) {
+                entry.slots[entry.count++] = coupon;
+                return;
+            }
+            uint32_t inlineCoupons[INLINE_COUPONS];
+            std::memcpy(inlineCoupons, entry.slots, sizeof(inlineCoupons));
+            const uint32_t offset = allocateSet(LG_MIN_SET_SIZE);
+            for (uint32_t i = 0; i < INLINE_COUPONS; i++) {
+                insertInSet(&couponSets[offset], LG_MIN_SET_SIZE, inlineCoupons[i]);
+            }
+            entry.stage = SET;
+            entry.lgSetSize = LG_MIN_SET_SIZE;
+            entry.slots[0] = offset;
+            addToSet(entry, coupon);
+            return;
+        }
+        case SET:
+            addToSet(entry, coupon);
+            return;
+        case HLL:
+            addToHll(entry.slots[0], coupon);
+            return;
+        default:
+            return;
+    }
+}
+
+double hll_map::estimate(const Entry &entry) const {
+    if (entry.stage == HLL) {
+        return hipStates[2 * static_cast<size_t>(entry.slots[0])];
+    }
+    return entry.count;
+}
+
+double hll_map::getEstimate(const void *key, size_t keyLength) const {
+    const Entry &entry = entries[find(fingerprint(key, keyLength), key, keyLength)];
+    return entry.stage == EMPTY ? 0 : estimate(entry);
+}
+
+size_t hll_map::getNumKeys() const {
+    return numKeys;
+}
+
+size_t hll_map::getMemoryUsage() const {
+    size_t usage = entries.capacity() * sizeof(Entry) + keys.capacity() + couponSets.capacity() * sizeof(uint32_t)
+                   + registers.capacity() + hipStates.capacity() * sizeof(double);
+    for (const std::vector<uint32_t> &freeList: freeSets) {
+        usage += freeList.capacity() * sizeof(uint32_t);
+    }
+    return usage;
+}
@@ -0,0 +1,50 @@
+#include "Vertica.h"
+#include "../../../include/datasketches/kll/kll_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function that builds a kll_sketch of doubles and returns it serialized.
+ * Based on example from https://datasketches.apache.org/docs/KLL/KLLSketch.html
+ */
+template<class Values>
+class KllAggregateCreate : public KllSketchAggregateFunction {
+public:
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            const size_t count = Values::update(*sketch, argReader);
+            LogTrace(traceLevel, TRACE_VERBOSE, srvInterface, "kll aggregate: %zu values, %u retained",
+                     count, sketch->get_num_retained());
+            serializeKllSketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+template<class Values>
+class KllAggregateCreateFactoryBase : public KllSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        Values::addArgumentType(argTypes);
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<KllAggregateCreate<Values>>(srvfloaterface.allocator);
+    }
+};
+
+class KllAggregateCreateFloatFactory : public KllAggregateCreateFactoryBase<KllFloatValues> {
+};
+
+class KllAggregateCreateIntFactory : public KllAggregateCreateFactoryBase<KllIntValues> {
+};
+
+RegisterFactory(KllAggregateCreateFloatFactory);
+RegisterFactory(KllAggregateCreateIntFactory);
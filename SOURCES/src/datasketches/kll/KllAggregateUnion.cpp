@@ -0,0 +1,44 @@
+#include "Vertica.h"
+#include "../../../include/datasketches/kll/kll_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function merging serialized kll_sketch, as returned by kll_sketch_create.
+ * Sketches of any k can be merged, the result keeps the k parameter.
+ */
+class KllAggregateUnion : public KllSketchAggregateFunction {
+public:
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                const VString &other = argReader.getStringRef(0);
+                if (!other.isNull()) {
+                    sketch->merge(kll_sketch_custom::deserialize(other.data(), other.length()));
+                }
+            } while (argReader.next());
+            serializeKllSketch(*sketch, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class KllAggregateUnionFactory : public KllSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<KllAggregateUnion>(srvfloaterface.allocator);
+    }
+};
+
+RegisterFactory(KllAggregateUnionFactory);
@@ -0,0 +1,191 @@
+#include <Vertica.h>
+#include <vector>
+#include "../../../include/datasketches/kll/kll_common.hpp"
+
+using namespace Vertica;
+
+/**
+ * kll_sketch_get_quantile(sketch, fraction): approximate value at the given normalized rank, between 0 and 1: the
+ * smallest value whose inclusive rank (fraction of the values at or below it) is at least fraction.
+ * NULL for an empty sketch.
+ */
+class KllSketchGetQuantile : public KllSketchScalarFunction {
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                auto sketch = getSketch(argReader.getStringRef(0));
+                if (sketch->is_empty()) {
+                    resWriter.setFloat(vfloat_null);
+                } else {
+                    resWriter.setFloat(sketch->get_quantile(argReader.getFloatRef(1), true));
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+/**
+ * kll_sketch_get_rank(sketch, value): approximate normalized rank of the given value, between 0 and 1, inclusive:
+ * the fraction of the values at or below it. NULL for an empty sketch.
+ */
+class KllSketchGetRank : public KllSketchScalarFunction {
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                auto sketch = getSketch(argReader.getStringRef(0));
+                if (sketch->is_empty()) {
+                    resWriter.setFloat(vfloat_null);
+                } else {
+                    resWriter.setFloat(sketch->get_rank(argReader.getFloatRef(1), true));
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+/**
+ * kll_sketch_get_quantiles(sketch, '[f1,f2,...]'): approximate values at the given normalized ranks, as
+ * kll_sketch_get_quantile computes them, as a '[v1,v2,...]' list. NULL for an empty sketch.
+ */
+class KllSketchGetQuantiles : public KllSketchScalarFunction {
+protected:
+    std::vector<double> fractions;
+    std::vector<double> quantiles;
+
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                auto sketch = getSketch(argReader.getStringRef(0));
+                VString &result = resWriter.getStringRef();
+                if (sketch->is_empty()) {
+                    result.setNull();
+                } else {
+                    parseDoubleList(argReader.getStringRef(1).str(), fractions);
+                    quantiles.clear();
+                    for (const double fraction: fractions) {
+                        quantiles.push_back(sketch->get_quantile(fraction, true));
+                    }
+                    result.copy(formatDoubleList(quantiles));
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+/**
+ * kll_sketch_get_pmf(sketch, '[s1,s2,...]'): approximate fractions of the values in each of the intervals
+ * delimited by the given increasing split points, (-inf, s1], (s1, s2], ..., (sn, +inf), as a '[m0,m1,...]' list.
+ * Intervals include their upper split point, as datasketches 4.x inclusive ranks, which are asked for explicitly.
+ * NULL for an empty sketch.
+ */
+class KllSketchGetPmf : public KllSketchScalarFunction {
+protected:
+    std::vector<double> splitPoints;
+
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                auto sketch = getSketch(argReader.getStringRef(0));
+                VString &result = resWriter.getStringRef();
+                if (sketch->is_empty()) {
+                    result.setNull();
+                } else {
+                    parseDoubleList(argReader.getStringRef(1).str(), splitPoints);
+                    result.copy(formatDoubleList(sketch->get_PMF(splitPoints.data(), splitPoints.size(), true)));
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class KllSketchGetQuantileFactory : public KllSketchScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<KllSketchGetQuantile>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addFloat();
+        returnType.addFloat();
+    }
+};
+
+class KllSketchGetRankFactory : public KllSketchScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<KllSketchGetRank>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addFloat();
+        returnType.addFloat();
+    }
+};
+
+template<class Function>
+class KllSketchListFactoryBase : public KllSketchScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<Function>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addVarchar();
+        returnType.addVarchar();
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &argTypes,
+                               SizedColumnTypes &returnType) {
+        returnType.addVarchar(65000);
+    }
+};
+
+class KllSketchGetQuantilesFactory : public KllSketchListFactoryBase<KllSketchGetQuantiles> {
+};
+
+class KllSketchGetPmfFactory : public KllSketchListFactoryBase<KllSketchGetPmf> {
+};
+
+RegisterFactory(KllSketchGetQuantileFactory);
+RegisterFactory(KllSketchGetRankFactory);
+RegisterFactory(KllSketchGetQuantilesFactory);
+RegisterFactory(KllSketchGetPmfFactory);
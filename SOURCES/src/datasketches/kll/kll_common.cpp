@@ -0,0 +1,61 @@
+#include <Vertica.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+#include "../../../include/datasketches/kll/kll_common.hpp"
+
+
+uint16_t readKllK(ServerInterface &serverInterface) {
+    vint k;
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_KLL_K_PARAMETER_NAME)) {
+        k = paramReader.getIntRef(DATASKETCHES_KLL_K_PARAMETER_NAME);
+        if (k < DATASKETCHES_KLL_K_MIN || k > DATASKETCHES_KLL_K_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_KLL_K_PARAMETER_NAME, DATASKETCHES_KLL_K_MIN, DATASKETCHES_KLL_K_MAX);
+        }
+    } else {
+        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
+                        DATASKETCHES_KLL_K_PARAMETER_NAME, DATASKETCHES_KLL_K_DEFAULT);
+        k = DATASKETCHES_KLL_K_DEFAULT;
+    }
+    return k;
+}
+
+uint32_t kllSketchMaxSize(uint16_t k) {
+    return std::min<size_t>(kll_sketch_custom::get_max_serialized_size_bytes(k, 1ULL << 48),
+                            DATASKETCHES_KLL_MAX_SERIALIZED_SIZE);
+}
+
+void parseDoubleList(const std::string &text, std::vector<double> &values) {
+    values.clear();
+    const char *p = text.c_str();
+    while (*p == ' ') p++;
+    const bool bracketed = *p == '[';
+    if (bracketed) p++;
+    while (true) {
+        char *end;
+        errno = 0;
+        const double value = std::strtod(p, &end);
+        if (end == p || errno != 0) {
+            throw std::invalid_argument("expected a list of numbers, got '" + text + "'");
+        }
+        values.push_back(value);
+        p = end;
+        while (*p == ' ') p++;
+        if (*p != ',') {
+            break;
+        }
+        p++;
+    }
+    if (bracketed && *p++ != ']') {
+        throw std::invalid_argument("missing ] in '" + text + "'");
+    }
+    while (*p == ' ') p++;
+    if (*p != '\0') {
+        throw std::invalid_argument("unexpected characters in '" + text + "'");
+    }
+}
@@ -3,32 +3,40 @@
 #include <theta_sketch.hpp>
 #include <theta_a_not_b.hpp>
 #include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_shards.hpp"
 
 using namespace Vertica;
 
-class ThetaSketchANotB : public ScalarFunction {
+/**
+ * A not B. With more than one thread, computed on sorted hashes, shard by shard.
+ */
+class ThetaSketchANotB : public ThetaSketchScalarFunction {
+    theta_hashes result;
+
 public:
     void processBlock(ServerInterface &srvInterface,
                       BlockReader &argReader,
                       BlockWriter &resWriter) {
         try {
-            auto seed = readSeed(srvInterface);
-            const SizedColumnTypes &inTypes = argReader.getTypeMetaData();
-            std::vector<size_t> argCols; // Argument column indexes.
-            inTypes.getArgumentColumns(argCols);
+            newBlock();
+            if (threads > 1) {
+                do {
+                    auto a = getHashes(argReader.getStringRef(0));
+                    auto b = getHashes(argReader.getStringRef(1));
+                    thetaShardedANotB(theta_hashes_view(*a), theta_hashes_view(*b), result, threads);
+                    serializeThetaSketch(theta_hashes_sketch(result, seedHash), resWriter.getStringRef(), compressed);
+                    resWriter.next();
+                } while (argReader.next());
+                return;
+            }
 
             auto aNotB = theta_a_not_b_custom(seed);
             // While we have inputs to process
             do {
-                auto a = compact_theta_sketch_custom::deserialize(argReader.getStringRef(0).data(),
-                                                                argReader.getStringRef(0).length(),
-                                                                seed);
-                auto b = compact_theta_sketch_custom::deserialize(argReader.getStringRef(1).data(),
-                                                                argReader.getStringRef(1).length(),
-                                                                seed);
-
-                auto data = aNotB.compute(a, b).serialize();
-                resWriter.getStringRef().copy((char *) &data[0], data.size());
+                auto a = getSketch(argReader.getStringRef(0));
+                auto b = getSketch(argReader.getStringRef(1));
+
+                serializeThetaSketch(aNotB.compute(*a, *b), resWriter.getStringRef(), compressed);
                 resWriter.next();
             } while (argReader.next());
         } catch (std::exception &e) {
@@ -51,6 +59,17 @@ class ThetaSketchANotBFactory : public ThetaSketchScalarFunctionFactory {
         argTypes.addLongVarbinary();
         returnType.addLongVarbinary();
     }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        ThetaSketchScalarFunctionFactory::getParameterType(srvInterface, parameterTypes);
+        addThreadsParameter(parameterTypes, "Worker threads of each difference, 1 by default.");
+    }
+
+    // A not B keeps at most the hashes of A.
+    virtual uint64_t maxResultEntries(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        return sketchMaxEntries(inputTypes.getColumnType(0).getStringLength());
+    }
 };
 
 RegisterFactory(ThetaSketchANotBFactory);
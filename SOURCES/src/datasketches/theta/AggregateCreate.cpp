@@ -15,14 +15,19 @@ using namespace std;
  */
 class ThetaSketchAggregateCreate : public ThetaSketchAggregateFunction {
     update_theta_sketch_custom updatex = update_theta_sketch_custom::builder().build();
+    float p;
+
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        ThetaSketchAggregateFunction::setup(srvInterface, argTypes);
+        this->p = readSamplingProbability(srvInterface);
+    }
 
     virtual void initAggregate(ServerInterface &srvInterface, 
                                IntermediateAggs &aggs)
     {
         try {
-            updatex = update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).build();
-            auto data = updatex.compact().serialize();
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            updatex = update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).set_p(p).build();
+            serializeThetaSketch(updatex, aggs.getStringRef(0));
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
@@ -36,8 +41,7 @@ class ThetaSketchAggregateCreate : public ThetaSketchAggregateFunction {
             do {
                 updatex.update(argReader.getStringRef(0).str());
             } while (argReader.next());
-            auto data = updatex.compact().serialize();
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            serializeThetaSketch(updatex, aggs.getStringRef(0));
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
@@ -48,26 +52,7 @@ class ThetaSketchAggregateCreate : public ThetaSketchAggregateFunction {
                          IntermediateAggs &aggs,
                          MultipleIntermediateAggs &aggsOther) override {
         try {
-            auto u = theta_union_custom::builder()
-                    .set_lg_k(logK)
-                    .set_seed(seed)
-                    .build();
-
-            auto sketch = compact_theta_sketch_custom::deserialize(aggs.getStringRef(0).data(),
-                                                            aggs.getStringRef(0).length(),
-                                                            seed);
-            u.update(sketch);
-
-            do {
-                sketch = compact_theta_sketch_custom::deserialize(aggsOther.getStringRef(0).data(),
-                                                           aggsOther.getStringRef(0).length(),
-                                                           seed);
-                u.update(sketch);
-            } while (aggsOther.next());
-
-            auto data = u.get_result().serialize();
-            aggs.getStringRef(0).copy((char *)&data[0], data.size());
-
+            combineUnion(srvInterface, aggs, aggsOther);
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
@@ -78,10 +63,20 @@ class ThetaSketchAggregateCreate : public ThetaSketchAggregateFunction {
 };
 
 
-class ThetaSketchAggregateCreateVarcharFactory : public ThetaSketchAggregateFunctionFactory {
+class ThetaSketchAggregateCreateFactory : public ThetaSketchAggregateFunctionFactory {
+protected:
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        ThetaSketchAggregateFunctionFactory::getParameterType(srvInterface, parameterTypes);
+        addSamplingProbabilityParameter(parameterTypes);
+    }
+};
+
+
+class ThetaSketchAggregateCreateVarcharFactory : public ThetaSketchAggregateCreateFactory {
     virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
         argTypes.addVarchar();
-        returnType.addVarbinary();
+        returnType.addLongVarbinary();
     }
 
     virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
@@ -90,10 +85,10 @@ class ThetaSketchAggregateCreateVarcharFactory : public ThetaSketchAggregateFunc
 };
 
 
-class ThetaSketchAggregateCreateVarbinaryFactory : public ThetaSketchAggregateFunctionFactory {
+class ThetaSketchAggregateCreateVarbinaryFactory : public ThetaSketchAggregateCreateFactory {
     virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
         argTypes.addVarbinary();
-        returnType.addVarbinary();
+        returnType.addLongVarbinary();
     }
 
     virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
@@ -107,18 +102,24 @@ class ThetaCreateUDTF : public TransformFunction
 protected:
     uint8_t logK;
     uint64_t seed;
+    uint8_t traceLevel;
+    bool compressed;
+    float p;
 
 public:
     virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
         this->logK = readLogK(srvInterface);
         this->seed = readSeed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->compressed = readCompressed(srvInterface);
+        this->p = readSamplingProbability(srvInterface);
     }
 
   virtual void processPartition(ServerInterface &srvInterface, 
                                 PartitionReader &inputReader, 
                                 PartitionWriter &outputWriter)
   {
-    auto updatex = update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).build();
+    auto updatex = update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).set_p(p).build();
     int wc = 0;
     try {
       if (inputReader.getNumCols() != 1)
@@ -129,9 +130,12 @@ public:
         updatex.update(inputReader.getStringRef(0).str());
         wc++;
       } while (inputReader.next() && !isCanceled());
-      srvInterface.log("UDTF Partition Count %d", wc);
-            auto data = updatex.compact().serialize();
-            outputWriter.getStringRef(0).copy((char *) &data[0], data.size());
+      LogTrace(traceLevel, TRACE_INFO, srvInterface, "UDTF Partition Count %d", wc);
+            if (compressed) {
+                serializeThetaSketch(updatex.compact(), outputWriter.getStringRef(0), true);
+            } else {
+                serializeThetaSketch(updatex, outputWriter.getStringRef(0));
+            }
       outputWriter.next();
     } catch(std::exception& e) {
       // Standard exception. Quit.
@@ -151,19 +155,16 @@ class ThetaCreateUDTFFactory : public TransformFunctionFactory
 
     virtual void getParameterType(ServerInterface &srvInterface,
                                   SizedColumnTypes &parameterTypes) {
-        // Unfortunately it cannot be forced in the intersection...
-        // So we have to trust the user to give the maximum logK used of the input sketches.
         SizedColumnTypes::Properties logNominalProps;
         logNominalProps.required = false;
         logNominalProps.canBeNull = false;
         logNominalProps.comment = "Log Nominal value.";
         parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
 
-        SizedColumnTypes::Properties seedProps;
-        seedProps.required = false;
-        seedProps.canBeNull = false;
-        seedProps.comment = "Seed value";
-        parameterTypes.addInt(DATASKETCHES_SEED_PARAMETER_NAME, seedProps);
+        addSeedParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addSamplingProbabilityParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
     }
 
   // Tell Vertica what our return string length will be, given the input
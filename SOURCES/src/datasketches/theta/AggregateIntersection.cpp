@@ -23,8 +23,7 @@ class ThetaSketchAggregateIntersection : public ThetaSketchAggregateFunction {
                     .set_lg_k(logK)
                     .set_seed(seed)
                     .build();
-            auto data = u.get_result().serialize(); // provides compact & rebuild sketch <=> min size
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            serializeThetaSketch(u.get_result(), aggs.getStringRef(0)); // provides compact & rebuild sketch <=> min size
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
@@ -39,22 +38,19 @@ class ThetaSketchAggregateIntersection : public ThetaSketchAggregateFunction {
             vbool &initialized = aggs.getBoolRef(1);
 
             if (initialized) {
-                auto aggSketch = compact_theta_sketch_custom::deserialize(aggs.getStringRef(0).data(),
-                                                                   aggs.getStringRef(0).length(),
-                                                                   seed);
+                auto aggSketch = deserializeThetaSketch(aggs.getStringRef(0).data(),
+                                                        aggs.getStringRef(0).length(), seed);
                 intersection.update(aggSketch);
             }
 
             do {
-                auto sketch = compact_theta_sketch_custom::deserialize(argReader.getStringRef(0).data(),
-                                                                argReader.getStringRef(0).length(),
-                                                                seed);
+                auto sketch = deserializeThetaSketch(argReader.getStringRef(0).data(),
+                                                     argReader.getStringRef(0).length(), seed);
                 intersection.update(sketch);
                 initialized = true;
             } while (argReader.next());
 
-            auto data = intersection.get_result().serialize();
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            serializeThetaSketch(intersection.get_result(), aggs.getStringRef(0));
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
@@ -69,26 +65,23 @@ class ThetaSketchAggregateIntersection : public ThetaSketchAggregateFunction {
             // Unsure if all aggregations here must have been used at least once or not.
             vbool &initialized = aggs.getBoolRef(1);
             if (initialized) {
-                auto initSketch = compact_theta_sketch_custom::deserialize(aggs.getStringRef(0).data(),
-                                                                    aggs.getStringRef(0).length(),
-                                                                    seed);
+                auto initSketch = deserializeThetaSketch(aggs.getStringRef(0).data(),
+                                                         aggs.getStringRef(0).length(), seed);
                 intersection.update(initSketch);
             }
 
             do {
                 vbool otherInitialized = aggsOther.getBoolRef(1);
                 if (otherInitialized) {
-                    auto sketch = compact_theta_sketch_custom::deserialize(aggsOther.getStringRef(0).data(),
-                                                                    aggsOther.getStringRef(0).length(),
-                                                                    seed);
+                    auto sketch = deserializeThetaSketch(aggsOther.getStringRef(0).data(),
+                                                         aggsOther.getStringRef(0).length(), seed);
                     intersection.update(sketch);
                     initialized = true;
                 }
             } while (aggsOther.next());
 
             if (intersection.has_result()) { // Overwrite empty sketch only if necessary
-                auto data = intersection.get_result().serialize();
-                aggs.getStringRef(0).copy((char *) &data[0], data.size());
+                serializeThetaSketch(intersection.get_result(), aggs.getStringRef(0));
             }
         } catch (exception &e) {
             // Standard exception. Quit.
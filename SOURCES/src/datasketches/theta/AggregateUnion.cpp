@@ -22,18 +22,14 @@ class ThetaSketchAggregateUnion : public ThetaSketchAggregateFunction {
                     .set_lg_k(logK)
                     .set_seed(seed)
                     .build();
-            auto sketch = compact_theta_sketch_custom::deserialize(aggs.getStringRef(0).data(),
-                                                            aggs.getStringRef(0).length(),
-                                                            seed);
+            auto sketch = deserializeThetaSketch(aggs.getStringRef(0).data(), aggs.getStringRef(0).length(), seed);
             u.update(sketch);
             do {
-                sketch = compact_theta_sketch_custom::deserialize(argReader.getStringRef(0).data(),
-                                                           argReader.getStringRef(0).length(),
-                                                           seed);
+                sketch = deserializeThetaSketch(argReader.getStringRef(0).data(),
+                                                argReader.getStringRef(0).length(), seed);
                 u.update(sketch);
             } while (argReader.next());
-            auto data = u.get_result().serialize();
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
+            serializeThetaSketch(u.get_result(), aggs.getStringRef(0));
 
         } catch (exception &e) {
             // Standard exception. Quit.
@@ -45,26 +41,7 @@ class ThetaSketchAggregateUnion : public ThetaSketchAggregateFunction {
                          IntermediateAggs &aggs,
                          MultipleIntermediateAggs &aggsOther) override {
         try {
-            auto u = theta_union_custom::builder()
-                    .set_lg_k(logK)
-                    .set_seed(seed)
-                    .build();
-
-            auto sketch = compact_theta_sketch_custom::deserialize(aggs.getStringRef(0).data(),
-                                                            aggs.getStringRef(0).length(),
-                                                            seed);
-            u.update(sketch);
-
-            do {
-                sketch = compact_theta_sketch_custom::deserialize(aggsOther.getStringRef(0).data(),
-                                                           aggsOther.getStringRef(0).length(),
-                                                           seed);
-                u.update(sketch);
-            } while (aggsOther.next());
-
-            auto data = u.get_result().serialize();
-            aggs.getStringRef(0).copy((char *) &data[0], data.size());
-
+            combineUnion(srvInterface, aggs, aggsOther);
         } catch (exception &e) {
             // Standard exception. Quit.
             vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
@@ -0,0 +1,149 @@
+#include "Vertica.h"
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_set_ops.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * theta_sketch_update(base_sketch, value): the union of base_sketch with the sketch of the values of the group,
+ * for adding new rows to a stored cumulative sketch. base_sketch is expected to be the same for every row of a
+ * group (e.g. joined from the cumulative table): only its first non NULL value is read, once, and kept as sorted
+ * hashes. New values go to a live update sketch, and each block ends with a linear merge of both instead of a
+ * theta_union, so the cost is about that of hashing the new values.
+ * k is the largest of 2^logK and the k derived from base_sketch, as the union in theta_sketch_union would derive
+ * it, so that a base sketch built with a larger k is not truncated.
+ */
+class ThetaSketchAggregateUpdate : public ThetaSketchAggregateFunction {
+    update_theta_sketch_custom updatex = update_theta_sketch_custom::builder().build();
+    uint16_t seedHash;
+    uint32_t k;
+    bool hasBase;
+    theta_hashes base;
+    theta_hashes result;
+    theta_hashes scratch;
+    std::vector<theta_hashes> partials;
+
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        ThetaSketchAggregateFunction::setup(srvInterface, argTypes);
+        this->seedHash = computeSeedHash(seed);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface,
+                               IntermediateAggs &aggs) {
+        try {
+            updatex = update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).build();
+            k = 1U << logK;
+            hasBase = false;
+            theta_hashes().swap(base);
+            serializeThetaSketch(updatex, aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                if (!hasBase) {
+                    const VString &bytes = argReader.getStringRef(0);
+                    if (!bytes.isNull()) {
+                        theta_hashes(deserializeThetaSketch(bytes.data(), bytes.length(), seed)).swap(base);
+                        hasBase = true;
+                        LogKDerivation derivation;
+                        derivation.add(base.entries.size(), base.theta);
+                        const uint8_t baseLogK = std::max(logK, derivation.getLogK());
+                        k = 1U << baseLogK;
+                        if (updatex.is_empty()) {
+                            // So that new values are kept at the precision of the base.
+                            updatex = update_theta_sketch_custom::builder().set_lg_k(baseLogK).set_seed(seed).build();
+                        }
+                    }
+                }
+                const VString &value = argReader.getStringRef(1);
+                if (!value.isNull() && value.length() > 0) {
+                    updatex.update(value.data(), value.length());
+                }
+            } while (argReader.next());
+
+            theta_hashes added(updatex.compact());
+            thetaUnion(theta_hashes_view(base), theta_hashes_view(added), k, result);
+            LogTrace(traceLevel, TRACE_VERBOSE, srvInterface, "theta update: %zu base hashes, %u new",
+                     base.entries.size(), updatex.get_num_retained());
+            serializeThetaSketch(theta_hashes_sketch(result, seedHash), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            // Every partial aggregate holds the base sketch, with the k it was given: k is derived from them
+            // rather than taken from logK.
+            LogKDerivation derivation;
+            partials.clear();
+            const VString &current = aggs.getStringRef(0);
+            partials.emplace_back(deserializeThetaSketch(current.data(), current.length(), seed));
+            derivation.add(partials.back().entries.size(), partials.back().theta);
+            do {
+                const VString &other = aggsOther.getStringRef(0);
+                partials.emplace_back(deserializeThetaSketch(other.data(), other.length(), seed));
+                derivation.add(partials.back().entries.size(), partials.back().theta);
+            } while (aggsOther.next());
+
+            const uint32_t combinedK = 1U << std::max(logK, derivation.getLogK());
+            theta_hashes().swap(result);
+            for (auto &partial: partials) {
+                thetaUnion(theta_hashes_view(result), theta_hashes_view(partial), combinedK, scratch);
+                result.swap(scratch);
+            }
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "theta update combine: merged %zu sketches, k %u",
+                     partials.size(), combinedK);
+            serializeThetaSketch(theta_hashes_sketch(result, seedHash), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class ThetaSketchAggregateUpdateFactory : public ThetaSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addVarchar();
+        returnType.addLongVarbinary();
+    }
+
+    // The result keeps up to the k of the base sketch, which may be larger than 2^logK: up to twice the hashes
+    // of an exact base.
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        intermediateTypeMetaData.addLongVarbinary(maxResultSize(srvInterface, inputTypes));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(maxResultSize(srvfloaterface, inputTypes));
+    }
+
+    static uint32_t maxResultSize(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        const uint64_t baseEntries = sketchMaxEntries(inputTypes.getColumnType(0).getStringLength());
+        return compactSketchMaxSize(std::max<uint64_t>(1ULL << readLogK(srvInterface), 2 * baseEntries));
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<ThetaSketchAggregateUpdate>(srvfloaterface.allocator);
+    }
+};
+
+RegisterFactory(ThetaSketchAggregateUpdateFactory);
@@ -0,0 +1,62 @@
+#include <Vertica.h>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+
+using namespace Vertica;
+
+/**
+ * Rewrites a stored sketch in the compressed format (delta encoded, bit packed hashes).
+ * Sketches already compressed, or not worth compressing (empty, single hash), are returned as is.
+ */
+class ThetaSketchCompress : public ThetaSketchScalarFunction {
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            // While we have inputs to process
+            do {
+                const VString &bytes = argReader.getStringRef(0);
+                if (bytes.isNull()) {
+                    resWriter.getStringRef().setNull();
+                } else if (theta_serde::isCompressed(bytes.data(), bytes.length())) {
+                    resWriter.getStringRef().copy(&bytes);
+                } else {
+                    serializeThetaSketch(*getSketch(bytes), resWriter.getStringRef(), true);
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaSketchCompressFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<ThetaSketchCompress>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        // Never larger than the input.
+        outputTypes.addLongVarbinary(inputTypes.getColumnType(0).getStringLength());
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+RegisterFactory(ThetaSketchCompressFactory);
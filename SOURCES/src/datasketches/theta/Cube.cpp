@@ -0,0 +1,180 @@
+#include <Vertica.h>
+#include <memory>
+#include <unordered_map>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_dimensions.hpp"
+
+using namespace Vertica;
+
+/**
+ * User Defined Transform Function computing the sketches of every grouping set of its dimensions, as
+ * GROUP BY CUBE(dims...) would, from a single scan of (dims..., value) rows. Values are hashed once, into the
+ * sketches of the finest grouping set. Every coarser grouping set is then derived, by decreasing number of
+ * dimensions, by merging the groups of the parent grouping set (one more dimension) having the fewest groups.
+ *
+ * Emits (grouping_id, dims..., sketch) rows where rolled up dimensions are NULL and grouping_id is the
+ * GROUPING_ID(dims...) of SQL: the bit of the first dimension is the most significant one, set when rolled up.
+ * Only the grouping sets of two consecutive levels are in memory at a time.
+ */
+class ThetaCubeUDTF : public TransformFunction {
+protected:
+    typedef std::unordered_map<std::string, compact_theta_sketch_custom> Cuboid;
+
+    uint8_t logK;
+    uint64_t seed;
+    bool compressed;
+    uint8_t traceLevel;
+    std::unique_ptr<DimensionColumns> dims;
+
+    vint groupingId(uint32_t mask) const {
+        vint id = 0;
+        for (size_t i = 0; i < dims->size(); i++) {
+            id = (id << 1) | ((mask >> i) & 1 ? 0 : 1);
+        }
+        return id;
+    }
+
+    void emit(uint32_t mask, const Cuboid &cuboid, PartitionWriter &outputWriter) {
+        const vint id = groupingId(mask);
+        for (auto &group: cuboid) {
+            outputWriter.setInt(0, id);
+            const char *value = group.first.data();
+            for (size_t i = 0; i < dims->size(); i++) {
+                value = dims->write(outputWriter, i, 1 + i, value);
+            }
+            serializeThetaSketch(group.second, outputWriter.getStringRef(1 + dims->size()), compressed);
+            outputWriter.next();
+        }
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->logK = readLogK(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->compressed = readCompressed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->dims.reset(new DimensionColumns(argTypes, 0, argTypes.getColumnCount() - 1));
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  PartitionReader &inputReader,
+                                  PartitionWriter &outputWriter) {
+        try {
+            const size_t numDims = dims->size();
+            const uint32_t full = (1U << numDims) - 1;
+            std::vector<std::unique_ptr<Cuboid>> cuboids(full + 1);
+
+            std::unordered_map<std::string, update_theta_sketch_custom> finest;
+            std::string key;
+            do {
+                key.clear();
+                for (size_t i = 0; i < numDims; i++) {
+                    dims->read(inputReader, i, key);
+                }
+                auto group = finest.find(key);
+                if (group == finest.end()) {
+                    group = finest.emplace(
+                            key, update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).build()).first;
+                }
+                // Empty strings are ignored, as theta_sketch_create does.
+                const VString &value = inputReader.getStringRef(numDims);
+                if (!value.isNull() && value.length() > 0) {
+                    group->second.update(value.data(), value.length());
+                }
+            } while (inputReader.next() && !isCanceled());
+
+            cuboids[full].reset(new Cuboid());
+            for (auto &group: finest) {
+                cuboids[full]->emplace(group.first, group.second.compact());
+            }
+            finest.clear();
+            emit(full, *cuboids[full], outputWriter);
+
+            std::string projected;
+            for (size_t level = numDims; level-- > 0 && !isCanceled();) {
+                for (uint32_t mask = 0; mask < full; mask++) {
+                    if (static_cast<size_t>(__builtin_popcount(mask)) != level) {
+                        continue;
+                    }
+                    uint32_t parent = 0;
+                    for (size_t i = 0; i < numDims; i++) {
+                        const uint32_t candidate = mask | (1U << i);
+                        if (candidate != mask
+                            && (parent == 0 || cuboids[candidate]->size() < cuboids[parent]->size())) {
+                            parent = candidate;
+                        }
+                    }
+
+                    std::unordered_map<std::string, theta_union_custom> unions;
+                    for (auto &group: *cuboids[parent]) {
+                        dims->project(group.first, mask, projected);
+                        auto u = unions.find(projected);
+                        if (u == unions.end()) {
+                            u = unions.emplace(
+                                    projected, theta_union_custom::builder().set_lg_k(logK).set_seed(seed).build()).first;
+                        }
+                        u->second.update(group.second);
+                    }
+                    cuboids[mask].reset(new Cuboid());
+                    for (auto &u: unions) {
+                        cuboids[mask]->emplace(u.first, u.second.get_result());
+                    }
+                    LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "cube: grouping %lld from %lld, %zu groups from %zu",
+                             (long long) groupingId(mask), (long long) groupingId(parent),
+                             cuboids[mask]->size(), cuboids[parent]->size());
+                    emit(mask, *cuboids[mask], outputWriter);
+                }
+                // Grouping sets of the level above are not parents anymore.
+                for (uint32_t mask = 0; mask <= full; mask++) {
+                    if (static_cast<size_t>(__builtin_popcount(mask)) == level + 1) {
+                        cuboids[mask].reset();
+                    }
+                }
+            }
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaCubeUDTFFactory : public TransformFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addAny();
+        returnType.addAny();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addSeedParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        const size_t numColumns = inputTypes.getColumnCount();
+        if (numColumns < 2 || numColumns - 1 > DATASKETCHES_CUBE_MAX_DIMENSIONS
+            || !inputTypes.getColumnType(numColumns - 1).isStringType()) {
+            vt_report_error(0, "Function expects (dimensions..., value VARCHAR) arguments, with 1 to %d dimensions",
+                            DATASKETCHES_CUBE_MAX_DIMENSIONS);
+        }
+
+        outputTypes.addInt("grouping_id");
+        DimensionColumns::addOutputTypes(inputTypes, 0, numColumns - 1, outputTypes);
+        outputTypes.addLongVarbinary(quickSelectSketchMaxSize(readLogK(srvInterface)), "sketch");
+    }
+
+    virtual TransformFunction *createTransformFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<ThetaCubeUDTF>(srvInterface.allocator);
+    }
+};
+
+RegisterFactory(ThetaCubeUDTFFactory);
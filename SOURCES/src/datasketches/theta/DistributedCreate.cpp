@@ -0,0 +1,157 @@
+#include <Vertica.h>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * First phase of theta_sketch_create_distributed, run as a prepass where the data is stored: every instance
+ * sketches the rows it is given and emits a single compact sketch, in partition 0 so that the second phase
+ * gets them all.
+ */
+class ThetaCreatePrepassUDTF : public TransformFunction {
+protected:
+    uint8_t logK;
+    uint64_t seed;
+    float p;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->logK = readLogK(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->p = readSamplingProbability(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  PartitionReader &inputReader,
+                                  PartitionWriter &outputWriter) {
+        try {
+            auto sketch = update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).set_p(p).build();
+            size_t rows = 0;
+            do {
+                const VString &value = inputReader.getStringRef(0);
+                if (!value.isNull() && value.length() > 0) {
+                    sketch.update(value.data(), value.length());
+                }
+                rows++;
+            } while (inputReader.next() && !isCanceled());
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "distributed create prepass: %zu rows, %u hashes",
+                     rows, sketch.get_num_retained());
+
+            outputWriter.setInt(0, 0);
+            serializeThetaSketch(sketch, outputWriter.getStringRef(1));
+            outputWriter.next();
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+};
+
+/**
+ * Second phase of theta_sketch_create_distributed: unions the sketches of the first phase, a single one
+ * per instance of it, into the final sketch.
+ */
+class ThetaCreateMergeUDTF : public TransformFunction {
+protected:
+    uint8_t logK;
+    uint64_t seed;
+    bool compressed;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->logK = readLogK(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->compressed = readCompressed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  PartitionReader &inputReader,
+                                  PartitionWriter &outputWriter) {
+        try {
+            auto u = theta_union_custom::builder().set_lg_k(logK).set_seed(seed).build();
+            size_t merged = 0;
+            do {
+                const VString &bytes = inputReader.getStringRef(1);
+                u.update(deserializeThetaSketch(bytes.data(), bytes.length(), seed));
+                merged++;
+            } while (inputReader.next() && !isCanceled());
+            LogTrace(traceLevel, TRACE_INFO, srvInterface, "distributed create: merged %zu sketches", merged);
+
+            serializeThetaSketch(u.get_result(), outputWriter.getStringRef(0), compressed);
+            outputWriter.next();
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaCreatePrepassPhase : public TransformFunctionPhase {
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        if (inputTypes.getColumnCount() != 1)
+            vt_report_error(0, "Function only accepts 1 argument, but %zu provided", inputTypes.getColumnCount());
+
+        outputTypes.addIntPartitionColumn("partition");
+        outputTypes.addLongVarbinary(quickSelectSketchMaxSize(readLogK(srvInterface)), "sketch");
+    }
+
+    virtual TransformFunction *createTransformFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<ThetaCreatePrepassUDTF>(srvInterface.allocator);
+    }
+};
+
+class ThetaCreateMergePhase : public TransformFunctionPhase {
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(quickSelectSketchMaxSize(readLogK(srvInterface)), "sketch");
+    }
+
+    virtual TransformFunction *createTransformFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<ThetaCreateMergeUDTF>(srvInterface.allocator);
+    }
+};
+
+/**
+ * theta_sketch_create_distributed(value) OVER (PARTITION AUTO): a sketch of the whole input, built in two
+ * phases instead of sending every row to a single partition. Only one compact sketch per instance of the
+ * first phase crosses the network.
+ */
+class ThetaCreateMultiPhaseFactory : public MultiPhaseTransformFunctionFactory {
+    ThetaCreatePrepassPhase prepassPhase;
+    ThetaCreateMergePhase mergePhase;
+
+    virtual void getPhases(ServerInterface &srvInterface, std::vector<TransformFunctionPhase *> &phases) {
+        prepassPhase.setPrepass();
+        phases.push_back(&prepassPhase);
+        phases.push_back(&mergePhase);
+    }
+
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addVarchar();
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addSeedParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addSamplingProbabilityParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+RegisterFactory(ThetaCreateMultiPhaseFactory);
@@ -0,0 +1,189 @@
+#include <Vertica.h>
+#include <cstring>
+#include <memory>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_expression.hpp"
+#include "../../../include/datasketches/theta/theta_set_ops.hpp"
+
+using namespace Vertica;
+
+/**
+ * theta_sketch_eval('(a|b)&c-d', a, b, c, d): evaluates a set expression over the sketch arguments in a single
+ * pass, see theta_expression.hpp for the syntax. Sketches are wrapped once as sorted arrays through the sketch
+ * cache, and intermediates stay in memory instead of being serialized between nested calls.
+ * The expression is compiled on the first row and again only when it changes. NULL if it or a sketch is NULL.
+ */
+class ThetaSketchEvalBase : public ScalarFunction {
+protected:
+    uint64_t seed;
+    uint16_t seedHash;
+    // 0 when derived from the inputs.
+    uint32_t k;
+    uint8_t traceLevel;
+    SketchCache<theta_hashes> cache;
+    std::unique_ptr<theta_expression> expression;
+    // Inputs of the current row, held until evaluated as the cache may evict them meanwhile.
+    std::vector<SketchCache<theta_hashes>::sketch_ptr> sketches;
+    std::vector<theta_hashes_view> inputs;
+
+    /**
+     * Evaluates the expression of the current row, or returns nullptr on NULL arguments.
+     */
+    const theta_hashes *evaluate(BlockReader &argReader) {
+        const VString &text = argReader.getStringRef(0);
+        if (text.isNull()) {
+            return nullptr;
+        }
+        if (!expression || expression->getText().size() != text.length()
+            || std::memcmp(expression->getText().data(), text.data(), text.length()) != 0) {
+            expression.reset(new theta_expression(text.str()));
+        }
+
+        const size_t numInputs = expression->getNumInputs();
+        if (argReader.getNumCols() - 1 < numInputs) {
+            throw std::invalid_argument("'" + expression->getText() + "' needs " + std::to_string(numInputs)
+                                        + " sketches, got " + std::to_string(argReader.getNumCols() - 1));
+        }
+        sketches.resize(numInputs);
+        inputs.resize(numInputs);
+        const uint64_t sketchSeed = seed;
+        for (size_t i = 0; i < numInputs; i++) {
+            const VString &bytes = argReader.getStringRef(i + 1);
+            if (bytes.isNull()) {
+                return nullptr;
+            }
+            sketches[i] = cache.get(bytes.data(), bytes.length(), [sketchSeed](const char *data, size_t length) {
+                return theta_hashes(deserializeThetaSketch(data, length, sketchSeed));
+            });
+            inputs[i] = theta_hashes_view(*sketches[i]);
+        }
+        if (k != 0) {
+            return &expression->evaluate(inputs, k);
+        }
+        LogKDerivation derivation;
+        for (size_t i = 0; i < numInputs; i++) {
+            derivation.add(sketches[i]->entries.size(), sketches[i]->theta);
+        }
+        return &expression->evaluate(inputs, 1U << derivation.getLogK());
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->seed = readSeed(srvInterface);
+        this->seedHash = computeSeedHash(seed);
+        // Without logK, k is derived from the inputs of every row, as theta_sketch_union does.
+        this->k = srvInterface.getParamReader().containsParameter(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME)
+                  ? 1U << readLogK(srvInterface) : 0;
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->cache.setCapacity(readCacheSize(srvInterface));
+    }
+
+    virtual void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        LogTrace(traceLevel, TRACE_INFO, srvInterface, "sketch cache: %llu hits, %llu misses",
+                 (unsigned long long) cache.getHits(), (unsigned long long) cache.getMisses());
+    }
+};
+
+class ThetaSketchEval : public ThetaSketchEvalBase {
+protected:
+    bool compressed;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        ThetaSketchEvalBase::setup(srvInterface, argTypes);
+        this->compressed = readCompressed(srvInterface);
+    }
+
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                const theta_hashes *result = evaluate(argReader);
+                if (result == nullptr) {
+                    resWriter.getStringRef().setNull();
+                } else {
+                    serializeThetaSketch(theta_hashes_sketch(*result, seedHash), resWriter.getStringRef(), compressed);
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaSketchEvalEstimate : public ThetaSketchEvalBase {
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                const theta_hashes *result = evaluate(argReader);
+                resWriter.setFloat(result == nullptr ? vfloat_null : result->getEstimate());
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaSketchEvalFactory : public ThetaSketchScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<ThetaSketchEval>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addAny();
+        returnType.addLongVarbinary();
+    }
+
+    // The hashes of all sketches at most, the first argument is the expression. Unions keep at most k hashes.
+    virtual uint64_t maxResultEntries(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        uint64_t entries = 0;
+        for (size_t i = 1; i < inputTypes.getColumnCount(); i++) {
+            entries += sketchMaxEntries(inputTypes.getColumnType(i).getStringLength());
+        }
+        if (srvInterface.getParamReader().containsParameter(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME)) {
+            entries = std::min<uint64_t>(entries, 1ULL << readLogK(srvInterface));
+        }
+        return entries;
+    }
+};
+
+class ThetaSketchEvalEstimateFactory : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<ThetaSketchEvalEstimate>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addAny();
+        returnType.addFloat();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value of the unions, derived from the sketches by default.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+RegisterFactory(ThetaSketchEvalFactory);
+RegisterFactory(ThetaSketchEvalEstimateFactory);
@@ -4,22 +4,16 @@
 
 using namespace Vertica;
 
-class ThetaSketchLBound : public ScalarFunction {
+class ThetaSketchLBound : public ThetaSketchScalarFunction {
 public:
     void processBlock(ServerInterface &srvInterface,
                       BlockReader &argReader,
                       BlockWriter &resWriter) {
         try {
-            auto seed = readSeed(srvInterface);
-            const SizedColumnTypes &inTypes = argReader.getTypeMetaData();
-            std::vector<size_t> argCols; // Argument column indexes.
-            inTypes.getArgumentColumns(argCols);
+            cache.newBlock();
             // While we have inputs to process
             do {
-                auto sketch = datasketches::compact_theta_sketch::deserialize(argReader.getStringRef(0).data(),
-                                                                              argReader.getStringRef(0).length(),
-                                                                              seed);
-                resWriter.setFloat(sketch.get_lower_bound(argReader.getIntRef(1)));
+                resWriter.setFloat(getSketch(argReader.getStringRef(0))->get_lower_bound(argReader.getIntRef(1)));
                 resWriter.next();
             } while (argReader.next());
         } catch (std::exception &e) {
@@ -45,30 +39,22 @@ class ThetaSketchGetLBoundFactory : public ScalarFunctionFactory {
 
     virtual void getParameterType(ServerInterface &srvInterface,
                                   SizedColumnTypes &parameterTypes) {
-        SizedColumnTypes::Properties seedProps;
-        seedProps.required = false;
-        seedProps.canBeNull = false;
-        seedProps.comment = "Seed value";
-        parameterTypes.addInt(DATASKETCHES_SEED_PARAMETER_NAME, seedProps);
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
     }
 };
 
-class ThetaSketchUBound : public ScalarFunction {
+class ThetaSketchUBound : public ThetaSketchScalarFunction {
 public:
     void processBlock(ServerInterface &srvInterface,
                       BlockReader &argReader,
                       BlockWriter &resWriter) {
         try {
-            auto seed = readSeed(srvInterface);
-            const SizedColumnTypes &inTypes = argReader.getTypeMetaData();
-            std::vector<size_t> argCols; // Argument column indexes.
-            inTypes.getArgumentColumns(argCols);
+            cache.newBlock();
             // While we have inputs to process
             do {
-                auto sketch = datasketches::compact_theta_sketch::deserialize(argReader.getStringRef(0).data(),
-                                                                              argReader.getStringRef(0).length(),
-                                                                              seed);
-                resWriter.setFloat(sketch.get_upper_bound(argReader.getIntRef(1)));
+                resWriter.setFloat(getSketch(argReader.getStringRef(0))->get_upper_bound(argReader.getIntRef(1)));
                 resWriter.next();
             } while (argReader.next());
         } catch (std::exception &e) {
@@ -94,11 +80,9 @@ class ThetaSketchGetUBoundFactory : public ScalarFunctionFactory {
 
     virtual void getParameterType(ServerInterface &srvInterface,
                                   SizedColumnTypes &parameterTypes) {
-        SizedColumnTypes::Properties seedProps;
-        seedProps.required = false;
-        seedProps.canBeNull = false;
-        seedProps.comment = "Seed value";
-        parameterTypes.addInt(DATASKETCHES_SEED_PARAMETER_NAME, seedProps);
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
     }
 };
 
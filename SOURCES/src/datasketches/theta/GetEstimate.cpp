@@ -4,22 +4,16 @@
 
 using namespace Vertica;
 
-class ThetaSketchGetEstimate : public ScalarFunction {
+class ThetaSketchGetEstimate : public ThetaSketchScalarFunction {
 public:
     void processBlock(ServerInterface &srvInterface,
                       BlockReader &argReader,
                       BlockWriter &resWriter) {
         try {
-            auto seed = readSeed(srvInterface);
-            const SizedColumnTypes &inTypes = argReader.getTypeMetaData();
-            std::vector<size_t> argCols; // Argument column indexes.
-            inTypes.getArgumentColumns(argCols);
+            cache.newBlock();
             // While we have inputs to process
             do {
-                auto sketch = datasketches::compact_theta_sketch::deserialize(argReader.getStringRef(0).data(),
-                                                                              argReader.getStringRef(0).length(),
-                                                                              seed);
-                resWriter.setFloat(sketch.get_estimate());
+                resWriter.setFloat(getSketch(argReader.getStringRef(0))->get_estimate());
                 resWriter.next();
             } while (argReader.next());
         } catch (std::exception &e) {
@@ -45,11 +39,9 @@ class ThetaSketchGetEstimateFactory : public ScalarFunctionFactory {
 
     virtual void getParameterType(ServerInterface &srvInterface,
                                   SizedColumnTypes &parameterTypes) {
-        SizedColumnTypes::Properties seedProps;
-        seedProps.required = false;
-        seedProps.canBeNull = false;
-        seedProps.comment = "Seed value";
-        parameterTypes.addInt(DATASKETCHES_SEED_PARAMETER_NAME, seedProps);
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
     }
 };
 
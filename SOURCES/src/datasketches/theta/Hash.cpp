@@ -0,0 +1,147 @@
+#include <Vertica.h>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_set_ops.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * theta_hash(value): the 64 bits hash theta_sketch_create computes for value with the given seed, to be
+ * materialized and sketched with theta_sketch_create_from_hash. NULL for NULL and empty values, which sketches
+ * ignore.
+ */
+class ThetaHash : public ScalarFunction {
+protected:
+    uint64_t seed;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->seed = readSeed(srvInterface);
+    }
+
+    virtual void processBlock(ServerInterface &srvInterface,
+                              BlockReader &argReader,
+                              BlockWriter &resWriter) {
+        try {
+            do {
+                const VString &value = argReader.getStringRef(0);
+                if (value.isNull() || value.length() == 0) {
+                    resWriter.setInt(vint_null);
+                } else {
+                    resWriter.setInt(static_cast<vint>(thetaHash(value.data(), value.length(), seed)));
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaHashFactory : public ScalarFunctionFactory {
+protected:
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<ThetaHash>(interface.allocator);
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+    }
+};
+
+class ThetaHashVarcharFactory : public ThetaHashFactory {
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addVarchar();
+        returnType.addInt();
+    }
+};
+
+class ThetaHashVarbinaryFactory : public ThetaHashFactory {
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addVarbinary();
+        returnType.addInt();
+    }
+};
+
+/**
+ * theta_sketch_create_from_hash(hash): sketch of the values a theta_hash column was computed from, without
+ * hashing nor string handling. Hashes go through a theta_hash_builder rather than an update_theta_sketch, which
+ * only takes values, so the sketch holds the k smallest hashes as the union of theta_sketch_create sketches of
+ * these values would, and merges with them given the same seed.
+ */
+class ThetaSketchAggregateCreateFromHash : public ThetaSketchAggregateFunction {
+    std::unique_ptr<theta_hash_builder> builder;
+    uint16_t seedHash;
+
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        ThetaSketchAggregateFunction::setup(srvInterface, argTypes);
+        this->builder.reset(new theta_hash_builder(1U << logK));
+        this->seedHash = computeSeedHash(seed);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface,
+                               IntermediateAggs &aggs) {
+        try {
+            builder->reset();
+            serializeThetaSketch(theta_hashes_sketch(builder->getResult(), seedHash), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                const vint hash = argReader.getIntRef(0);
+                if (hash == vint_null) {
+                    continue;
+                }
+                if (hash < 0) {
+                    throw invalid_argument("negative value " + to_string(hash) + " is not a theta_hash");
+                }
+                builder->update(static_cast<uint64_t>(hash));
+            } while (argReader.next());
+            serializeThetaSketch(theta_hashes_sketch(builder->getResult(), seedHash), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            combineUnion(srvInterface, aggs, aggsOther);
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class ThetaSketchAggregateCreateFromHashFactory : public ThetaSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addInt();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<ThetaSketchAggregateCreateFromHash>(srvfloaterface.allocator);
+    }
+};
+
+RegisterFactory(ThetaHashVarcharFactory);
+RegisterFactory(ThetaHashVarbinaryFactory);
+RegisterFactory(ThetaSketchAggregateCreateFromHashFactory);
@@ -0,0 +1,98 @@
+#include <Vertica.h>
+#include <vector>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_overlap.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Transform Function computing the overlap matrix of the (id, sketch) rows of a partition:
+ * one (i, j, intersection, jaccard) row for every pair of ids, with i the id of the earlier row of the pair.
+ * Sketches are read and sorted once, then all pairs are counted by theta_overlap on worker threads.
+ * Rows with a NULL id or sketch are skipped.
+ */
+class ThetaOverlapMatrixUDTF : public TransformFunction {
+protected:
+    uint64_t seed;
+    unsigned threads;
+    uint8_t traceLevel;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->seed = readSeed(srvInterface);
+        this->threads = readThreads(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  PartitionReader &inputReader,
+                                  PartitionWriter &outputWriter) {
+        try {
+            std::vector<vint> ids;
+            std::vector<theta_hashes> sketches;
+            do {
+                const vint id = inputReader.getIntRef(0);
+                const VString &bytes = inputReader.getStringRef(1);
+                if (id != vint_null && !bytes.isNull()) {
+                    ids.push_back(id);
+                    sketches.push_back(theta_hashes(deserializeThetaSketch(bytes.data(), bytes.length(), seed)));
+                }
+            } while (inputReader.next() && !isCanceled());
+
+            theta_overlap overlap(sketches);
+            overlap.compute(threads);
+            LogTrace(traceLevel, TRACE_INFO, srvInterface, "overlap matrix: %zu sketches, %u threads",
+                     sketches.size(), threads);
+
+            for (size_t i = 0; i < ids.size() && !isCanceled(); i++) {
+                for (size_t j = i + 1; j < ids.size(); j++) {
+                    outputWriter.setInt(0, ids[i]);
+                    outputWriter.setInt(1, ids[j]);
+                    outputWriter.setFloat(2, overlap.getIntersectionEstimate(i, j));
+                    outputWriter.setFloat(3, overlap.getJaccard(i, j));
+                    outputWriter.next();
+                }
+            }
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaOverlapMatrixUDTFFactory : public TransformFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addInt();
+        argTypes.addLongVarbinary();
+        returnType.addInt();
+        returnType.addInt();
+        returnType.addFloat();
+        returnType.addFloat();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+        addThreadsParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        if (inputTypes.getColumnCount() != 2)
+            vt_report_error(0, "Function only accepts 2 arguments, but %zu provided", inputTypes.getColumnCount());
+
+        outputTypes.addInt("i");
+        outputTypes.addInt("j");
+        outputTypes.addFloat("intersection");
+        outputTypes.addFloat("jaccard");
+    }
+
+    virtual TransformFunction *createTransformFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<ThetaOverlapMatrixUDTF>(srvInterface.allocator);
+    }
+};
+
+RegisterFactory(ThetaOverlapMatrixUDTFFactory);
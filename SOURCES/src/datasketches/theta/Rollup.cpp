@@ -0,0 +1,173 @@
+#include <Vertica.h>
+#include <memory>
+#include <unordered_map>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_dimensions.hpp"
+#include "../../../include/datasketches/theta/theta_rollup.hpp"
+
+using namespace Vertica;
+
+static std::vector<rollup_granularity> readGranularities(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+    std::string list = DATASKETCHES_GRANULARITIES_DEFAULT;
+    if (paramReader.containsParameter(DATASKETCHES_GRANULARITIES_PARAMETER_NAME)) {
+        list = paramReader.getStringRef(DATASKETCHES_GRANULARITIES_PARAMETER_NAME).str();
+    }
+    try {
+        return parseRollupGranularities(list);
+    } catch (std::invalid_argument &e) {
+        vt_report_error(2, "Provided value of the %s parameter is not supported: %s",
+                        DATASKETCHES_GRANULARITIES_PARAMETER_NAME, e.what());
+        return std::vector<rollup_granularity>();
+    }
+}
+
+/**
+ * User Defined Transform Function rolling up (time, dims..., sketch) rows sorted by time into one sketch per
+ * bucket of every granularity and dimension values, in a single pass: every input sketch is deserialized once
+ * and merged into the open bucket of each granularity. A bucket is emitted as a
+ * (granularity, bucket, dims..., sketch) row as soon as a row of a later bucket comes, so memory is bounded by
+ * the open buckets. Rows with a NULL time or sketch are skipped.
+ */
+class ThetaRollupUDTF : public TransformFunction {
+protected:
+    uint8_t logK;
+    uint64_t seed;
+    bool compressed;
+    uint8_t traceLevel;
+    std::vector<rollup_granularity> granularities;
+    std::unique_ptr<DimensionColumns> dims;
+
+    struct Level {
+        rollup_granularity granularity;
+        Timestamp start;
+        // Open buckets by encoded dimension values.
+        std::unordered_map<std::string, theta_union_custom> buckets;
+    };
+
+    void emit(Level &level, PartitionWriter &outputWriter) {
+        for (auto &bucket: level.buckets) {
+            outputWriter.getStringRef(0).copy(rollupGranularityName(level.granularity));
+            outputWriter.setTimestamp(1, level.start);
+            const char *value = bucket.first.data();
+            for (size_t i = 0; i < dims->size(); i++) {
+                value = dims->write(outputWriter, i, 2 + i, value);
+            }
+            serializeThetaSketch(bucket.second.get_result(), outputWriter.getStringRef(2 + dims->size()), compressed);
+            outputWriter.next();
+        }
+        level.buckets.clear();
+    }
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        this->logK = readLogK(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->compressed = readCompressed(srvInterface);
+        this->traceLevel = readTraceLevel(srvInterface);
+        this->granularities = readGranularities(srvInterface);
+        this->dims.reset(new DimensionColumns(argTypes, 1, argTypes.getColumnCount() - 2));
+    }
+
+    virtual void processPartition(ServerInterface &srvInterface,
+                                  PartitionReader &inputReader,
+                                  PartitionWriter &outputWriter) {
+        try {
+            std::vector<Level> levels(granularities.size());
+            for (size_t g = 0; g < granularities.size(); g++) {
+                levels[g].granularity = granularities[g];
+            }
+            const size_t sketchColumn = 1 + dims->size();
+            std::string key;
+            size_t rows = 0;
+            do {
+                const Timestamp time = inputReader.getTimestampRef(0);
+                const VString &bytes = inputReader.getStringRef(sketchColumn);
+                if (time == vint_null || bytes.isNull()) {
+                    continue;
+                }
+                auto sketch = deserializeThetaSketch(bytes.data(), bytes.length(), seed);
+                key.clear();
+                for (size_t i = 0; i < dims->size(); i++) {
+                    dims->read(inputReader, i, key);
+                }
+
+                for (Level &level: levels) {
+                    const Timestamp start = rollupBucketStart(time, level.granularity);
+                    if (!level.buckets.empty() && start != level.start) {
+                        if (start < level.start) {
+                            throw std::invalid_argument("rows are not sorted by time, add ORDER BY time to the OVER clause");
+                        }
+                        emit(level, outputWriter);
+                    }
+                    level.start = start;
+                    auto bucket = level.buckets.find(key);
+                    if (bucket == level.buckets.end()) {
+                        bucket = level.buckets.emplace(
+                                key, theta_union_custom::builder().set_lg_k(logK).set_seed(seed).build()).first;
+                    }
+                    bucket->second.update(sketch);
+                }
+                rows++;
+            } while (inputReader.next() && !isCanceled());
+
+            for (Level &level: levels) {
+                emit(level, outputWriter);
+            }
+            LogTrace(traceLevel, TRACE_INFO, srvInterface, "rollup: %zu sketches into %zu granularities",
+                     rows, levels.size());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing partition: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaRollupUDTFFactory : public TransformFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addAny();
+        returnType.addAny();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        SizedColumnTypes::Properties granularitiesProps;
+        granularitiesProps.required = false;
+        granularitiesProps.canBeNull = false;
+        granularitiesProps.comment = "Comma separated granularities among hour, day, week, month and year.";
+        parameterTypes.addVarchar(64, DATASKETCHES_GRANULARITIES_PARAMETER_NAME, granularitiesProps);
+
+        addSeedParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        const size_t numColumns = inputTypes.getColumnCount();
+        if (numColumns < 2 || !inputTypes.getColumnType(0).isTimestamp()
+            || !(inputTypes.getColumnType(numColumns - 1).isVarbinary()
+                 || inputTypes.getColumnType(numColumns - 1).isLongVarbinary())) {
+            vt_report_error(0, "Function expects (time TIMESTAMP, dimensions..., sketch VARBINARY) arguments");
+        }
+        readGranularities(srvInterface);
+
+        outputTypes.addVarchar(8, "granularity");
+        outputTypes.addTimestamp("bucket");
+        DimensionColumns::addOutputTypes(inputTypes, 1, numColumns - 2, outputTypes);
+        outputTypes.addLongVarbinary(quickSelectSketchMinSize(readLogK(srvInterface)), "sketch");
+    }
+
+    virtual TransformFunction *createTransformFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<ThetaRollupUDTF>(srvInterface.allocator);
+    }
+};
+
+RegisterFactory(ThetaRollupUDTFFactory);
@@ -2,30 +2,41 @@
 #include <theta_sketch.hpp>
 #include <theta_intersection.hpp>
 #include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_shards.hpp"
 
 using namespace Vertica;
 
-class ThetaSketchScalarIntersection : public ScalarFunction {
+/**
+ * Intersection of any number of sketches. With more than one thread, inputs are intersected as sorted hashes,
+ * shard by shard.
+ */
+class ThetaSketchScalarIntersection : public ThetaSketchScalarFunction {
+    std::vector<SketchCache<theta_hashes>::sketch_ptr> hashes;
+    theta_hashes result;
+    theta_hashes scratch;
+
 public:
     void processBlock(ServerInterface &srvInterface,
                       BlockReader &argReader,
                       BlockWriter &resWriter) {
         try {
-            auto seed = readSeed(srvInterface);
+            newBlock();
             const SizedColumnTypes &inTypes = argReader.getTypeMetaData();
             std::vector<size_t> argCols; // Argument column indexes.
             inTypes.getArgumentColumns(argCols);
 
+            if (threads > 1) {
+                processBlockSharded(argReader, resWriter, argCols.size());
+                return;
+            }
+
             // While we have inputs to process
             do {
                 auto intersection = theta_intersection_custom(seed);
                 for (uint i = 0; i < argCols.size(); i++) {
-                    auto sketch = compact_theta_sketch_custom::deserialize(argReader.getStringRef(i).data(),
-                                                                    argReader.getStringRef(i).length());
-                    intersection.update(sketch);
+                    intersection.update(*getSketch(argReader.getStringRef(i)));
                 }
-                auto data = intersection.get_result().serialize();
-                resWriter.getStringRef().copy((char *) &data[0], data.size());
+                serializeThetaSketch(intersection.get_result(), resWriter.getStringRef(), compressed);
                 resWriter.next();
             } while (argReader.next());
         } catch (std::exception &e) {
@@ -33,6 +44,28 @@ public:
             vt_report_error(0, "Exception while processing block: [%s]", e.what());
         }
     }
+
+private:
+    void processBlockSharded(BlockReader &argReader, BlockWriter &resWriter, size_t numArgs) {
+        do {
+            // Inputs are held until the result is written, as views of the intermediate results point into them.
+            hashes.clear();
+            for (size_t i = 0; i < numArgs; i++) {
+                hashes.push_back(getHashes(argReader.getStringRef(i)));
+            }
+            theta_hashes_view current(*hashes[0]);
+            for (size_t i = 1; i < numArgs; i++) {
+                thetaShardedIntersection(current, theta_hashes_view(*hashes[i]), scratch, threads);
+                result.swap(scratch);
+                current = theta_hashes_view(result);
+            }
+            if (numArgs == 1) {
+                result = *hashes[0];
+            }
+            serializeThetaSketch(theta_hashes_sketch(result, seedHash), resWriter.getStringRef(), compressed);
+            resWriter.next();
+        } while (argReader.next());
+    }
 };
 
 class ThetaSketchScalarIntersectionFactory : public ThetaSketchScalarFunctionFactory {
@@ -47,6 +80,21 @@ class ThetaSketchScalarIntersectionFactory : public ThetaSketchScalarFunctionFac
         argTypes.addAny();
         returnType.addLongVarbinary();
     }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        ThetaSketchScalarFunctionFactory::getParameterType(srvInterface, parameterTypes);
+        addThreadsParameter(parameterTypes, "Worker threads of each intersection, 1 by default.");
+    }
+
+    // The intersection keeps at most the hashes of its smallest input.
+    virtual uint64_t maxResultEntries(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        uint64_t entries = sketchMaxEntries(inputTypes.getColumnType(0).getStringLength());
+        for (size_t i = 1; i < inputTypes.getColumnCount(); i++) {
+            entries = std::min<uint64_t>(entries, sketchMaxEntries(inputTypes.getColumnType(i).getStringLength()));
+        }
+        return entries;
+    }
 };
 
 RegisterFactory(ThetaSketchScalarIntersectionFactory);
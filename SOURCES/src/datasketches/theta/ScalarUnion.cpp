@@ -2,34 +2,62 @@
 #include <theta_sketch.hpp>
 #include <theta_union.hpp>
 #include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_shards.hpp"
 
 using namespace Vertica;
 
-class ThetaSketchScalarUnion : public ScalarFunction {
+/**
+ * Union of any number of sketches. Without a logK parameter, k is derived from the inputs: when they are all exact,
+ * the smallest power of 2 holding all their hashes, so that their union stays exact; otherwise the k of the most
+ * accurate input, so that the union is as accurate as its inputs without k growing with every nested union. Either
+ * way at least the default k (see LogKDerivation).
+ */
+class ThetaSketchScalarUnion : public ThetaSketchScalarFunction {
+    uint8_t logK;
+    bool deriveLogK;
+    std::vector<SketchCache<compact_theta_sketch_custom>::sketch_ptr> sketches;
+    std::vector<SketchCache<theta_hashes>::sketch_ptr> hashes;
+    theta_hashes result;
+    theta_hashes scratch;
+
 public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        ThetaSketchScalarFunction::setup(srvInterface, argTypes);
+        this->deriveLogK = !srvInterface.getParamReader().containsParameter(
+                DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME);
+        this->logK = deriveLogK ? DATASKETCHES_LOG_NOMINAL_VALUE_DEFAULT : readLogK(srvInterface);
+    }
+
     void processBlock(ServerInterface &srvInterface,
                       BlockReader &argReader,
                       BlockWriter &resWriter) {
         try {
-            auto logK = readLogK(srvInterface);
-            auto seed = readSeed(srvInterface);
+            newBlock();
             const SizedColumnTypes &inTypes = argReader.getTypeMetaData();
             std::vector<size_t> argCols; // Argument column indexes.
             inTypes.getArgumentColumns(argCols);
 
+            if (threads > 1) {
+                processBlockSharded(argReader, resWriter, argCols.size());
+                return;
+            }
+
             // While we have inputs to process
             do {
+                sketches.clear();
+                LogKDerivation derivation;
+                for (uint i = 0; i < argCols.size(); i++) {
+                    sketches.push_back(getSketch(argReader.getStringRef(i)));
+                    derivation.add(sketches.back()->get_num_retained(), sketches.back()->get_theta64());
+                }
                 auto u = theta_union_custom::builder()
-                        .set_lg_k(logK)
+                        .set_lg_k(deriveLogK ? derivation.getLogK() : logK)
                         .set_seed(seed)
                         .build();
-                for (uint i = 0; i < argCols.size(); i++) {
-                    auto sketch = compact_theta_sketch_custom::deserialize(argReader.getStringRef(i).data(),
-                                                                    argReader.getStringRef(i).length());
-                    u.update(sketch);
+                for (auto &sketch: sketches) {
+                    u.update(*sketch);
                 }
-                auto data = u.get_result().serialize();
-                resWriter.getStringRef().copy((char *) &data[0], data.size());
+                serializeThetaSketch(u.get_result(), resWriter.getStringRef(), compressed);
                 resWriter.next();
             } while (argReader.next());
         } catch (std::exception &e) {
@@ -37,6 +65,26 @@ public:
             vt_report_error(0, "Exception while processing block: [%s]", e.what());
         }
     }
+
+private:
+    void processBlockSharded(BlockReader &argReader, BlockWriter &resWriter, size_t numArgs) {
+        do {
+            hashes.clear();
+            LogKDerivation derivation;
+            for (size_t i = 0; i < numArgs; i++) {
+                hashes.push_back(getHashes(argReader.getStringRef(i)));
+                derivation.add(hashes.back()->entries.size(), hashes.back()->theta);
+            }
+            const uint32_t k = 1U << (deriveLogK ? derivation.getLogK() : logK);
+            theta_hashes().swap(result);
+            for (auto &input: hashes) {
+                thetaShardedUnion(theta_hashes_view(result), theta_hashes_view(*input), k, scratch, threads);
+                result.swap(scratch);
+            }
+            serializeThetaSketch(theta_hashes_sketch(result, seedHash), resWriter.getStringRef(), compressed);
+            resWriter.next();
+        } while (argReader.next());
+    }
 };
 
 class ThetaSketchScalarUnionFactory : public ThetaSketchScalarFunctionFactory {
@@ -51,6 +99,21 @@ class ThetaSketchScalarUnionFactory : public ThetaSketchScalarFunctionFactory {
         argTypes.addAny();
         returnType.addLongVarbinary();
     }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        ThetaSketchScalarFunctionFactory::getParameterType(srvInterface, parameterTypes);
+        addThreadsParameter(parameterTypes, "Worker threads of each union, 1 by default.");
+    }
+
+    // The union keeps at most k hashes.
+    virtual uint64_t maxResultEntries(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        uint64_t entries = ThetaSketchScalarFunctionFactory::maxResultEntries(srvInterface, inputTypes);
+        if (srvInterface.getParamReader().containsParameter(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME)) {
+            entries = std::min<uint64_t>(entries, 1ULL << readLogK(srvInterface));
+        }
+        return entries;
+    }
 };
 
 RegisterFactory(ThetaSketchScalarUnionFactory);
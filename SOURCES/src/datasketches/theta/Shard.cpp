@@ -0,0 +1,198 @@
+#include "Vertica.h"
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_shards.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * theta_sketch_shard(sketch, shard): the hashes of sketch in hash range shard (from 0 to 2^lgShards - 1), as a
+ * sketch with the same theta. Joined with the shard numbers, it stores a sketch as 2^lgShards rows, so that set
+ * operations grouped by shard run in parallel across threads and nodes, and theta_sketch_unshard concatenates
+ * their results. Consecutive rows of the same sketch deserialize it once.
+ */
+class ThetaSketchShard : public ThetaSketchScalarFunction {
+    uint8_t lgShards;
+    theta_hashes shard;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        ThetaSketchScalarFunction::setup(srvInterface, argTypes);
+        this->lgShards = readLgShards(srvInterface);
+    }
+
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            newBlock();
+            do {
+                const VString &bytes = argReader.getStringRef(0);
+                const vint shardIndex = argReader.getIntRef(1);
+                if (bytes.isNull() || shardIndex == vint_null) {
+                    resWriter.getStringRef().setNull();
+                    resWriter.next();
+                    continue;
+                }
+                if (shardIndex < 0 || shardIndex >= (1LL << lgShards)) {
+                    throw invalid_argument("shard " + to_string(shardIndex) + " is not between 0 and "
+                                           + to_string((1LL << lgShards) - 1));
+                }
+                auto input = getHashes(bytes);
+                const theta_hashes_view view = thetaShard(theta_hashes_view(*input),
+                                                          static_cast<uint32_t>(shardIndex), lgShards);
+                shard.theta = view.theta;
+                shard.empty = view.empty;
+                shard.entries.assign(view.begin, view.end);
+                serializeThetaSketch(theta_hashes_sketch(shard, seedHash), resWriter.getStringRef(), compressed);
+                resWriter.next();
+            } while (argReader.next());
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+class ThetaSketchShardFactory : public ThetaSketchScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<ThetaSketchShard>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        argTypes.addInt();
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addLgShardsParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    // A shard keeps at most the hashes of its sketch.
+    virtual uint64_t maxResultEntries(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        return sketchMaxEntries(inputTypes.getColumnType(0).getStringLength());
+    }
+};
+
+/**
+ * theta_sketch_unshard(shard_sketch): concatenation of the shards of a sketch, or of the shard by shard results
+ * of a set operation, into one sketch. Unlike a union it keeps all the hashes below the minimum theta, without
+ * the k limit, so that it is exact for the results of intersections and differences as well.
+ */
+class ThetaSketchAggregateUnshard : public ThetaSketchAggregateFunction {
+    uint16_t seedHash;
+    std::vector<theta_hashes> inputs;
+    std::vector<theta_hashes_view> views;
+    theta_hashes result;
+
+    void addInput(const VString &bytes) {
+        if (!bytes.isNull()) {
+            inputs.push_back(theta_hashes(deserializeThetaSketch(bytes.data(), bytes.length(), seed)));
+        }
+    }
+
+    void concatenateTo(VString &out) {
+        views.clear();
+        for (const theta_hashes &input: inputs) {
+            views.push_back(theta_hashes_view(input));
+        }
+        thetaConcatenate(views, result);
+        inputs.clear();
+        serializeThetaSketch(theta_hashes_sketch(result, seedHash), out);
+    }
+
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        ThetaSketchAggregateFunction::setup(srvInterface, argTypes);
+        this->seedHash = computeSeedHash(seed);
+    }
+
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            serializeThetaSketch(theta_hashes_sketch(theta_hashes(), seedHash), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            addInput(aggs.getStringRef(0));
+            do {
+                addInput(argReader.getStringRef(0));
+            } while (argReader.next());
+            concatenateTo(aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) override {
+        try {
+            addInput(aggs.getStringRef(0));
+            do {
+                addInput(aggsOther.getStringRef(0));
+            } while (aggsOther.next());
+            LogTrace(traceLevel, TRACE_DEBUG, srvInterface, "theta unshard combine: %zu sketches", inputs.size());
+            concatenateTo(aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class ThetaSketchAggregateUnshardFactory : public ThetaSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    // Every shard may hold as many hashes as its column.
+    static uint32_t maxSize(ServerInterface &srvInterface, const SizedColumnTypes &inputTypes) {
+        const uint64_t shardEntries = sketchMaxEntries(inputTypes.getColumnType(0).getStringLength());
+        return compactSketchMaxSize(shardEntries << readLgShards(srvInterface));
+    }
+
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        intermediateTypeMetaData.addLongVarbinary(maxSize(srvInterface, inputTypes));
+    }
+
+    virtual void getReturnType(ServerInterface &srvfloaterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(maxSize(srvfloaterface, inputTypes));
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+        addCompressedParameter(parameterTypes);
+        addLgShardsParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<ThetaSketchAggregateUnshard>(srvfloaterface.allocator);
+    }
+};
+
+RegisterFactory(ThetaSketchShardFactory);
+RegisterFactory(ThetaSketchAggregateUnshardFactory);
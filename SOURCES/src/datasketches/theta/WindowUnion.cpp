@@ -0,0 +1,164 @@
+#include <Vertica.h>
+#include "../../../include/datasketches/theta/theta_common.hpp"
+#include "../../../include/datasketches/theta/theta_set_ops.hpp"
+#include "../../../include/datasketches/window_analytic.hpp"
+
+using namespace Vertica;
+
+/**
+ * Panes and window unions as sorted hashes, unioned with the k of logK.
+ */
+class ThetaWindow {
+public:
+    typedef theta_hashes value_type;
+
+    void setup(ServerInterface &srvInterface) {
+        this->logK = readLogK(srvInterface);
+        this->seed = readSeed(srvInterface);
+        this->k = 1U << logK;
+    }
+
+    value_type combine(const value_type &older, const value_type &newer) const {
+        value_type result;
+        thetaUnion(theta_hashes_view(older), theta_hashes_view(newer), k, result);
+        return result;
+    }
+
+protected:
+    uint8_t logK;
+    uint64_t seed;
+    uint32_t k;
+};
+
+/**
+ * theta_sketch_window_union(sketch): panes are the union of their sketches, the result is the window sketch.
+ */
+class ThetaWindowSketches : public ThetaWindow {
+public:
+    void setup(ServerInterface &srvInterface) {
+        ThetaWindow::setup(srvInterface);
+        this->seedHash = computeSeedHash(seed);
+        this->compressed = readCompressed(srvInterface);
+    }
+
+    void add(AnalyticPartitionReader &inputReader) {
+        const VString &bytes = inputReader.getStringRef(0);
+        if (bytes.isNull()) {
+            return;
+        }
+        theta_hashes sketch(deserializeThetaSketch(bytes.data(), bytes.length(), seed));
+        theta_hashes result;
+        thetaUnion(theta_hashes_view(pane), theta_hashes_view(sketch), k, result);
+        pane.swap(result);
+    }
+
+    value_type takePane() {
+        value_type result;
+        result.swap(pane);
+        return result;
+    }
+
+    void write(AnalyticPartitionWriter &outputWriter, const value_type &result) const {
+        serializeThetaSketch(theta_hashes_sketch(result, seedHash), outputWriter.getStringRef(0), compressed);
+    }
+
+private:
+    uint16_t seedHash;
+    bool compressed;
+    theta_hashes pane;
+};
+
+/**
+ * theta_sketch_window_estimate(value): panes are sketched from their values, the result is the window estimate.
+ */
+class ThetaWindowValues : public ThetaWindow {
+public:
+    void setup(ServerInterface &srvInterface) {
+        ThetaWindow::setup(srvInterface);
+        newPane();
+    }
+
+    void add(AnalyticPartitionReader &inputReader) {
+        const VString &value = inputReader.getStringRef(0);
+        if (!value.isNull() && value.length() > 0) {
+            pane->update(value.data(), value.length());
+        }
+    }
+
+    value_type takePane() {
+        value_type result(pane->compact());
+        newPane();
+        return result;
+    }
+
+    void write(AnalyticPartitionWriter &outputWriter, const value_type &result) const {
+        outputWriter.setFloat(0, result.getEstimate());
+    }
+
+private:
+    std::unique_ptr<update_theta_sketch_custom> pane;
+
+    void newPane() {
+        pane.reset(new update_theta_sketch_custom(
+                update_theta_sketch_custom::builder().set_lg_k(logK).set_seed(seed).build()));
+    }
+};
+
+class ThetaWindowAnalyticFactory : public AnalyticFunctionFactory {
+protected:
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        SizedColumnTypes::Properties logNominalProps;
+        logNominalProps.required = false;
+        logNominalProps.canBeNull = false;
+        logNominalProps.comment = "Log Nominal value.";
+        parameterTypes.addInt(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, logNominalProps);
+
+        addWindowParameter(parameterTypes);
+        addSeedParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+class ThetaWindowUnionFactory : public ThetaWindowAnalyticFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        ThetaWindowAnalyticFactory::getParameterType(srvInterface, parameterTypes);
+        addCompressedParameter(parameterTypes);
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addLongVarbinary(quickSelectSketchMinSize(readLogK(srvInterface)));
+    }
+
+    virtual AnalyticFunction *createAnalyticFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<SlidingWindowAnalytic<ThetaWindowSketches>>(srvInterface.allocator);
+    }
+};
+
+class ThetaWindowEstimateFactory : public ThetaWindowAnalyticFactory {
+    virtual void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addVarchar();
+        returnType.addFloat();
+    }
+
+    virtual void getReturnType(ServerInterface &srvInterface,
+                               const SizedColumnTypes &inputTypes,
+                               SizedColumnTypes &outputTypes) {
+        outputTypes.addFloat();
+    }
+
+    virtual AnalyticFunction *createAnalyticFunction(ServerInterface &srvInterface) {
+        return vt_createFuncObject<SlidingWindowAnalytic<ThetaWindowValues>>(srvInterface.allocator);
+    }
+};
+
+RegisterFactory(ThetaWindowUnionFactory);
+RegisterFactory(ThetaWindowEstimateFactory);
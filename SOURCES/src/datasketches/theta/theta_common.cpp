@@ -1,4 +1,5 @@
 #include <Vertica.h>
+#include <algorithm>
 #include "../../../include/datasketches/theta/theta_common.hpp"
 
 
@@ -22,25 +23,96 @@ uint8_t readLogK(ServerInterface &serverInterface) {
     return logK;
 }
 
-uint64_t readSeed(ServerInterface &serverInterface) {
-    vint seed;
+bool readCompressed(ServerInterface &serverInterface) {
     ParamReader paramReader = serverInterface.getParamReader();
 
-    if (paramReader.containsParameter(DATASKETCHES_SEED_PARAMETER_NAME)) {
-        seed = paramReader.getIntRef(DATASKETCHES_SEED_PARAMETER_NAME);
-    } else {
-        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
-                        DATASKETCHES_SEED_PARAMETER_NAME, DATASKETCHES_SEED_DEFAULT);
-        seed = DATASKETCHES_SEED_DEFAULT;
+    if (paramReader.containsParameter(DATASKETCHES_COMPRESSED_PARAMETER_NAME)) {
+        return paramReader.getBoolRef(DATASKETCHES_COMPRESSED_PARAMETER_NAME) == vbool_true;
+    }
+    return false;
+}
+
+float readSamplingProbability(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_SAMPLING_PROBABILITY_PARAMETER_NAME)) {
+        vfloat p = paramReader.getFloatRef(DATASKETCHES_SAMPLING_PROBABILITY_PARAMETER_NAME);
+        if (!(p > 0 && p <= 1)) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be in (0, 1]",
+                            DATASKETCHES_SAMPLING_PROBABILITY_PARAMETER_NAME);
+        }
+        return static_cast<float>(p);
+    }
+    return DATASKETCHES_SAMPLING_PROBABILITY_DEFAULT;
+}
+
+uint8_t readLgShards(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_LG_SHARDS_PARAMETER_NAME)) {
+        vint lgShards = paramReader.getIntRef(DATASKETCHES_LG_SHARDS_PARAMETER_NAME);
+        if (lgShards < 0 || lgShards > DATASKETCHES_LG_SHARDS_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_LG_SHARDS_PARAMETER_NAME, 0, DATASKETCHES_LG_SHARDS_MAX);
+        }
+        return lgShards;
     }
-    return seed;
+    return DATASKETCHES_LG_SHARDS_DEFAULT;
+}
+
+void addCompressedParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties compressedProps;
+    compressedProps.required = false;
+    compressedProps.canBeNull = false;
+    compressedProps.comment = "Returns the sketch in the compressed format (serial version 4).";
+    parameterTypes.addBool(DATASKETCHES_COMPRESSED_PARAMETER_NAME, compressedProps);
 }
 
+void addSamplingProbabilityParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties pProps;
+    pProps.required = false;
+    pProps.canBeNull = false;
+    pProps.comment = "Initial sampling probability: only this fraction of the hashes is ever looked at, "
+                     "trading accuracy for speed. Defaults to 1.";
+    parameterTypes.addFloat(DATASKETCHES_SAMPLING_PROBABILITY_PARAMETER_NAME, pProps);
+}
+
+void addLgShardsParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties lgShardsProps;
+    lgShardsProps.required = false;
+    lgShardsProps.canBeNull = false;
+    lgShardsProps.comment = "Log2 of the number of hash range shards.";
+    parameterTypes.addInt(DATASKETCHES_LG_SHARDS_PARAMETER_NAME, lgShardsProps);
+}
+
+compact_theta_sketch_custom deserializeThetaSketch(const char *data, size_t length, uint64_t seed) {
+    if (!theta_serde::isCompressed(data, length)) {
+        return compact_theta_sketch_custom::deserialize(data, length, seed);
+    }
+    const theta_serde::CompressedPreamble preamble = theta_serde::readCompressedPreamble(data, length);
+    if (preamble.seedHash != computeSeedHash(seed)) {
+        throw std::invalid_argument("Incompatible seed hashes: " + std::to_string(preamble.seedHash) + ", "
+                                    + std::to_string(computeSeedHash(seed)));
+    }
+    theta_entries_custom entries(preamble.numEntries);
+    theta_serde::unpackCompressedEntries(data, preamble, entries.data());
+    return compact_theta_sketch_custom(false, true, preamble.seedHash, preamble.theta, std::move(entries));
+}
 
 uint32_t quickSelectSketchMinSize(uint8_t logK) {
-    return 24 + (1 << logK) * 8;
+    return compactSketchMaxSize(1ULL << logK);
 }
 
 uint32_t quickSelectSketchMaxSize(uint8_t logK) {
-    return 24 + (1 << logK) * 15;
+    return std::min<uint64_t>(24 + (1ULL << logK) * 15, DATASKETCHES_THETA_MAX_SERIALIZED_SIZE);
+}
+
+uint32_t compactSketchMaxSize(uint64_t numEntries) {
+    return std::min<uint64_t>(24 + numEntries * sizeof(uint64_t), DATASKETCHES_THETA_MAX_SERIALIZED_SIZE);
+}
+
+uint64_t sketchMaxEntries(vsize columnLength) {
+    return columnLength / (theta_serde::MIN_COMPRESSED_ENTRY_BITS / 8);
 }
\ No newline at end of file
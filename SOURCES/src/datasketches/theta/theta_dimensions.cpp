@@ -0,0 +1,108 @@
+#include <cstring>
+#include "../../../include/datasketches/theta/theta_dimensions.hpp"
+
+static const char NULL_TAG = 0;
+static const char VALUE_TAG = 1;
+
+DimensionColumns::Kind DimensionColumns::kindOf(const SizedColumnTypes &inputTypes, size_t column) {
+    const VerticaType &type = inputTypes.getColumnType(column);
+    if (type.isInt()) {
+        return INT_DIMENSION;
+    }
+    if (type.isStringType()) {
+        return STRING_DIMENSION;
+    }
+    vt_report_error(0, "Unsupported type for dimension column %zu: only integer and character string dimensions "
+                       "are supported, cast other types to VARCHAR", column + 1);
+    return STRING_DIMENSION;
+}
+
+DimensionColumns::DimensionColumns(const SizedColumnTypes &inputTypes, size_t first, size_t count) : first(first) {
+    for (size_t i = 0; i < count; i++) {
+        kinds.push_back(kindOf(inputTypes, first + i));
+    }
+}
+
+void DimensionColumns::read(PartitionReader &inputReader, size_t i, std::string &key) const {
+    if (kinds[i] == INT_DIMENSION) {
+        const vint value = inputReader.getIntRef(first + i);
+        if (value == vint_null) {
+            appendNull(key);
+            return;
+        }
+        key.push_back(VALUE_TAG);
+        key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    } else {
+        const VString &value = inputReader.getStringRef(first + i);
+        if (value.isNull()) {
+            appendNull(key);
+            return;
+        }
+        const uint32_t length = value.length();
+        key.push_back(VALUE_TAG);
+        key.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        key.append(value.data(), length);
+    }
+}
+
+void DimensionColumns::appendNull(std::string &key) {
+    key.push_back(NULL_TAG);
+}
+
+const char *DimensionColumns::skip(size_t i, const char *value) const {
+    if (*value++ == NULL_TAG) {
+        return value;
+    }
+    if (kinds[i] == INT_DIMENSION) {
+        return value + sizeof(vint);
+    }
+    uint32_t length;
+    std::memcpy(&length, value, sizeof(length));
+    return value + sizeof(length) + length;
+}
+
+void DimensionColumns::project(const std::string &key, uint32_t mask, std::string &projected) const {
+    projected.clear();
+    const char *value = key.data();
+    for (size_t i = 0; i < kinds.size(); i++) {
+        const char *end = skip(i, value);
+        if (mask & (1U << i)) {
+            projected.append(value, end - value);
+        } else {
+            appendNull(projected);
+        }
+        value = end;
+    }
+}
+
+const char *DimensionColumns::write(PartitionWriter &outputWriter, size_t i, size_t column, const char *value) const {
+    const bool isNull = *value++ == NULL_TAG;
+    if (kinds[i] == INT_DIMENSION) {
+        if (isNull) {
+            outputWriter.setInt(column, vint_null);
+            return value;
+        }
+        vint intValue;
+        std::memcpy(&intValue, value, sizeof(intValue));
+        outputWriter.setInt(column, intValue);
+        return value + sizeof(intValue);
+    }
+    if (isNull) {
+        outputWriter.getStringRef(column).setNull();
+        return value;
+    }
+    uint32_t length;
+    std::memcpy(&length, value, sizeof(length));
+    value += sizeof(length);
+    outputWriter.getStringRef(column).copy(value, length);
+    return value + length;
+}
+
+void DimensionColumns::addOutputTypes(const SizedColumnTypes &inputTypes, size_t first, size_t count,
+                                      SizedColumnTypes &outputTypes) {
+    for (size_t i = 0; i < count; i++) {
+        kindOf(inputTypes, first + i);
+        const std::string &name = inputTypes.getColumnName(first + i);
+        outputTypes.addArg(inputTypes.getColumnType(first + i), name.empty() ? "dim" + std::to_string(i + 1) : name);
+    }
+}
@@ -0,0 +1,123 @@
+#include <cctype>
+#include <stdexcept>
+#include "../../../include/datasketches/theta/theta_expression.hpp"
+
+theta_expression::theta_expression(const std::string &text) : text(text), numInputs(0) {
+    size_t position = skipSpaces(parseExpression(0));
+    if (position != text.size()) {
+        fail(position, "unexpected character");
+    }
+    size_t depth = 0;
+    size_t maxDepth = 0;
+    for (const Op &op: program) {
+        depth += op.code == INPUT ? 1 : -1;
+        maxDepth = depth > maxDepth ? depth : maxDepth;
+    }
+    stack.resize(maxDepth);
+    buffers.resize(maxDepth);
+}
+
+const std::string &theta_expression::getText() const {
+    return text;
+}
+
+size_t theta_expression::getNumInputs() const {
+    return numInputs;
+}
+
+size_t theta_expression::skipSpaces(size_t position) const {
+    while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+        position++;
+    }
+    return position;
+}
+
+void theta_expression::fail(size_t position, const char *message) const {
+    throw std::invalid_argument(std::string(message) + " at position " + std::to_string(position + 1)
+                                + " of '" + text + "'");
+}
+
+size_t theta_expression::parseExpression(size_t position) {
+    position = parseTerm(position);
+    while (true) {
+        position = skipSpaces(position);
+        if (position == text.size() || (text[position] != '|' && text[position] != '-')) {
+            return position;
+        }
+        const OpCode code = text[position] == '|' ? UNION : A_NOT_B;
+        position = parseTerm(position + 1);
+        program.push_back(Op{code, 0});
+    }
+}
+
+size_t theta_expression::parseTerm(size_t position) {
+    position = parseFactor(position);
+    while (true) {
+        position = skipSpaces(position);
+        if (position == text.size() || text[position] != '&') {
+            return position;
+        }
+        position = parseFactor(position + 1);
+        program.push_back(Op{INTERSECTION, 0});
+    }
+}
+
+size_t theta_expression::parseFactor(size_t position) {
+    position = skipSpaces(position);
+    if (position == text.size()) {
+        fail(position, "missing operand");
+    }
+    const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[position])));
+    if (c == '(') {
+        position = skipSpaces(parseExpression(position + 1));
+        if (position == text.size() || text[position] != ')') {
+            fail(position, "missing )");
+        }
+        return position + 1;
+    }
+    if (c >= 'a' && c <= 'z') {
+        const uint8_t input = static_cast<uint8_t>(c - 'a');
+        numInputs = input + 1u > numInputs ? input + 1u : numInputs;
+        program.push_back(Op{INPUT, input});
+        return position + 1;
+    }
+    fail(position, "expected a variable or (");
+}
+
+const theta_hashes &theta_expression::evaluate(const std::vector<theta_hashes_view> &inputs, uint32_t k) {
+    if (inputs.size() < numInputs) {
+        throw std::invalid_argument("'" + text + "' needs " + std::to_string(numInputs) + " sketches, got "
+                                    + std::to_string(inputs.size()));
+    }
+    size_t depth = 0;
+    for (const Op &op: program) {
+        if (op.code == INPUT) {
+            stack[depth++] = inputs[op.input];
+            continue;
+        }
+        depth--;
+        const theta_hashes_view &a = stack[depth - 1];
+        const theta_hashes_view &b = stack[depth];
+        switch (op.code) {
+            case UNION:
+                thetaUnion(a, b, k, scratch);
+                break;
+            case INTERSECTION:
+                thetaIntersection(a, b, scratch);
+                break;
+            default:
+                thetaANotB(a, b, scratch);
+        }
+        // The left operand may be the buffer of this depth, so the result is swapped in only once computed.
+        scratch.swap(buffers[depth - 1]);
+        stack[depth - 1] = theta_hashes_view(buffers[depth - 1]);
+    }
+    if (program.size() > 1) {
+        return buffers[0];
+    }
+    const theta_hashes_view &top = stack[0];
+    result.theta = top.theta;
+    result.empty = top.empty;
+    result.entries.assign(top.begin, top.end);
+    return result;
+}
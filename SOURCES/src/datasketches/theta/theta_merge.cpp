@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "../../../include/datasketches/theta/theta_merge.hpp"
+#include "../../../include/datasketches/theta/theta_serde.hpp"
+
+using namespace theta_serde;
+
+ordered_theta_merge::ordered_theta_merge(uint8_t logK, uint64_t seed)
+        : k(1U << logK), seedHash(computeSeedHash(seed)) {
+    reset();
+}
+
+void ordered_theta_merge::reset() {
+    mergeable = true;
+    empty = true;
+    theta = MAX_THETA;
+    maxEntries = 0;
+    inputs.clear();
+    runs.clear();
+}
+
+void ordered_theta_merge::add(const char *data, size_t length) {
+    inputs.push_back(std::make_pair(data, length));
+    if (!mergeable) {
+        return;
+    }
+    mergeable = false;
+
+    if (length < 8) {
+        return;
+    }
+    const uint8_t preambleLongs = data[0];
+    const uint8_t flags = data[5];
+    if (data[1] != SERIAL_VERSION || data[2] != COMPACT_SKETCH_TYPE || preambleLongs < 1 || preambleLongs > 3
+        || (flags & FLAG_BIG_ENDIAN) != 0) {
+        return;
+    }
+    if ((flags & FLAG_EMPTY) != 0) {
+        // Empty sketches do not contribute, not even their theta.
+        mergeable = true;
+        return;
+    }
+    if (readAt<uint16_t>(data + 6) != seedHash) {
+        return;
+    }
+
+    uint32_t numEntries = 1;
+    uint64_t sketchTheta = MAX_THETA;
+    if (preambleLongs > 1) {
+        if (length < 16 || (flags & FLAG_ORDERED) == 0) {
+            return;
+        }
+        numEntries = readAt<uint32_t>(data + 8);
+    }
+    if (preambleLongs > 2) {
+        if (length < 24) {
+            return;
+        }
+        sketchTheta = readAt<uint64_t>(data + 16);
+    }
+    const size_t entriesOffset = preambleLongs * 8;
+    if (length < entriesOffset + static_cast<size_t>(numEntries) * 8) {
+        return;
+    }
+
+    mergeable = true;
+    empty = false;
+    theta = std::min(theta, sketchTheta);
+    maxEntries += numEntries;
+    if (numEntries > 0) {
+        runs.push_back(Run{data + entriesOffset, data + entriesOffset + static_cast<size_t>(numEntries) * 8});
+    }
+}
+
+bool ordered_theta_merge::canMerge() const {
+    return mergeable;
+}
+
+const std::vector<std::pair<const char *, size_t>> &ordered_theta_merge::getInputs() const {
+    return inputs;
+}
+
+size_t ordered_theta_merge::getMaxSerializedSize() const {
+    return MAX_PREAMBLE_BYTES + std::min<size_t>(maxEntries, k) * 8;
+}
+
+size_t ordered_theta_merge::serializeTo(char *out) {
+    // Hashes are written after the largest preamble, and moved down once the actual preamble is known.
+    char *entries = out + MAX_PREAMBLE_BYTES;
+    uint32_t numEntries = 0;
+    uint64_t last = 0;
+
+    typedef std::greater<std::pair<uint64_t, uint32_t>> min_first;
+    heap.clear();
+    for (uint32_t i = 0; i < runs.size(); i++) {
+        heap.push_back(std::make_pair(readAt<uint64_t>(runs[i].next), i));
+    }
+    std::make_heap(heap.begin(), heap.end(), min_first());
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), min_first());
+        const uint64_t hash = heap.back().first;
+        Run &run = runs[heap.back().second];
+        if (hash >= theta) {
+            // Runs are sorted: nothing left in this one is retained.
+            heap.pop_back();
+            continue;
+        }
+        if (numEntries == 0 || hash != last) {
+            if (numEntries == k) {
+                // The k+1-th distinct hash becomes theta, as in theta_union.
+                theta = hash;
+                break;
+            }
+            writeAt(entries + static_cast<size_t>(numEntries) * 8, hash);
+            numEntries++;
+            last = hash;
+        }
+        run.next += 8;
+        if (run.next == run.end) {
+            heap.pop_back();
+        } else {
+            heap.back().first = readAt<uint64_t>(run.next);
+            std::push_heap(heap.begin(), heap.end(), min_first());
+        }
+    }
+
+    const size_t preambleBytes = writePreamble(out, empty, seedHash, theta, numEntries);
+    if (preambleBytes < MAX_PREAMBLE_BYTES) {
+        std::memmove(out + preambleBytes, entries, static_cast<size_t>(numEntries) * 8);
+    }
+    return preambleBytes + static_cast<size_t>(numEntries) * 8;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <atomic>
+#include "../../../include/datasketches/theta/theta_overlap.hpp"
+#include "../../../include/datasketches/theta/theta_serde.hpp"
+#include "../../../include/datasketches/workers.hpp"
+
+static const size_t BLOCK_SIZE = 4;
+
+/**
+ * Number of hashes in both sorted ranges. Ranges are merged block by block: all pairs of a block of each are
+ * compared, which the compiler vectorizes, and the block with the smaller last hash moves on. The tails are
+ * merged one hash at a time, without branches.
+ */
+static uint32_t countCommon(const uint64_t *a, const uint64_t *endA, const uint64_t *b, const uint64_t *endB) {
+    uint32_t count = 0;
+    while (a + BLOCK_SIZE <= endA && b + BLOCK_SIZE <= endB) {
+        uint32_t blockCount = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; i++) {
+            for (size_t j = 0; j < BLOCK_SIZE; j++) {
+                blockCount += a[i] == b[j];
+            }
+        }
+        count += blockCount;
+        const uint64_t lastA = a[BLOCK_SIZE - 1];
+        const uint64_t lastB = b[BLOCK_SIZE - 1];
+        a += (lastA <= lastB) * BLOCK_SIZE;
+        b += (lastB <= lastA) * BLOCK_SIZE;
+    }
+    while (a < endA && b < endB) {
+        const uint64_t x = *a;
+        const uint64_t y = *b;
+        count += x == y;
+        a += x <= y;
+        b += y <= x;
+    }
+    return count;
+}
+
+theta_overlap::theta_overlap(const std::vector<theta_hashes> &sketches)
+        : sketches(sketches), counts(sketches.size() * (sketches.size() - (sketches.empty() ? 0 : 1)) / 2) {
+}
+
+size_t theta_overlap::pairIndex(size_t i, size_t j) const {
+    return i * sketches.size() - i * (i + 1) / 2 + (j - i - 1);
+}
+
+uint64_t theta_overlap::pairTheta(size_t i, size_t j) const {
+    return std::min(sketches[i].theta, sketches[j].theta);
+}
+
+size_t theta_overlap::countBelow(size_t i, uint64_t theta) const {
+    const theta_entries_custom &entries = sketches[i].entries;
+    if (theta >= sketches[i].theta) {
+        return entries.size();
+    }
+    return std::lower_bound(entries.begin(), entries.end(), theta) - entries.begin();
+}
+
+void theta_overlap::computeTile(size_t tileRow, size_t tileColumn) {
+    const size_t n = sketches.size();
+    const size_t rowEnd = std::min(n, (tileRow + 1) * TILE_SIZE);
+    const size_t columnEnd = std::min(n, (tileColumn + 1) * TILE_SIZE);
+    for (size_t i = tileRow * TILE_SIZE; i < rowEnd; i++) {
+        const uint64_t *a = sketches[i].entries.data();
+        for (size_t j = std::max(i + 1, tileColumn * TILE_SIZE); j < columnEnd; j++) {
+            const uint64_t theta = pairTheta(i, j);
+            const uint64_t *b = sketches[j].entries.data();
+            counts[pairIndex(i, j)] = countCommon(a, a + countBelow(i, theta), b, b + countBelow(j, theta));
+        }
+    }
+}
+
+void theta_overlap::compute(unsigned numThreads) {
+    const size_t numTiles = (sketches.size() + TILE_SIZE - 1) / TILE_SIZE;
+    // Tiles on or above the diagonal, as (row, column).
+    std::vector<std::pair<size_t, size_t>> tiles;
+    for (size_t row = 0; row < numTiles; row++) {
+        for (size_t column = row; column < numTiles; column++) {
+            tiles.push_back(std::make_pair(row, column));
+        }
+    }
+
+    std::atomic<size_t> nextTile(0);
+    auto worker = [this, &tiles, &nextTile]() {
+        for (size_t tile = nextTile++; tile < tiles.size(); tile = nextTile++) {
+            computeTile(tiles[tile].first, tiles[tile].second);
+        }
+    };
+    runWorkers(std::max(1U, std::min<unsigned>(numThreads, tiles.size())), worker);
+}
+
+double theta_overlap::getIntersectionEstimate(size_t i, size_t j) const {
+    const double thetaFraction = static_cast<double>(pairTheta(i, j)) / theta_serde::MAX_THETA;
+    return counts[pairIndex(i, j)] / thetaFraction;
+}
+
+double theta_overlap::getJaccard(size_t i, size_t j) const {
+    const uint64_t theta = pairTheta(i, j);
+    const uint32_t common = counts[pairIndex(i, j)];
+    const size_t either = countBelow(i, theta) + countBelow(j, theta) - common;
+    return either == 0 ? 1.0 : static_cast<double>(common) / either;
+}
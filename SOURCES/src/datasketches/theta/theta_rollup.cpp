@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <stdexcept>
+#include "../../../include/datasketches/theta/theta_rollup.hpp"
+
+static const int64_t MICROS_PER_HOUR = 3600LL * 1000000;
+static const int64_t MICROS_PER_DAY = 24 * MICROS_PER_HOUR;
+// 2000-01-01 was a Saturday, day 5 of an ISO week counted from 0.
+static const int64_t EPOCH_DAY_OF_WEEK = 5;
+static const char *const GRANULARITY_NAMES[] = {"hour", "day", "week", "month", "year"};
+
+static int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+// Conversions between days since 2000-01-01 and civil dates, after
+// http://howardhinnant.github.io/date_algorithms.html with eras starting on March 1st 2000.
+static void civilFromDays(int64_t days, int64_t &year, int64_t &month) {
+    const int64_t shifted = days - 60;
+    const int64_t era = floorDiv(shifted, 146097);
+    const int64_t dayOfEra = shifted - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = 2000 + era * 400 + yearOfEra + (month <= 2);
+}
+
+static int64_t daysFromCivil(int64_t year, int64_t month) {
+    year -= month <= 2;
+    const int64_t era = floorDiv(year - 2000, 400);
+    const int64_t yearOfEra = year - 2000 - era * 400;
+    const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra + 60;
+}
+
+std::vector<rollup_granularity> parseRollupGranularities(const std::string &list) {
+    std::vector<rollup_granularity> granularities;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string name = list.substr(start, end - start);
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+        size_t g = 0;
+        while (g <= ROLLUP_YEAR && name != GRANULARITY_NAMES[g]) {
+            g++;
+        }
+        if (g > ROLLUP_YEAR) {
+            throw std::invalid_argument("unknown granularity '" + name + "', expected hour, day, week, month or year");
+        }
+        if (std::find(granularities.begin(), granularities.end(), g) != granularities.end()) {
+            throw std::invalid_argument("granularity '" + name + "' is given twice");
+        }
+        granularities.push_back(static_cast<rollup_granularity>(g));
+        start = end + 1;
+    }
+    return granularities;
+}
+
+const char *rollupGranularityName(rollup_granularity granularity) {
+    return GRANULARITY_NAMES[granularity];
+}
+
+int64_t rollupBucketStart(int64_t timestamp, rollup_granularity granularity) {
+    if (granularity == ROLLUP_HOUR) {
+        return floorDiv(timestamp, MICROS_PER_HOUR) * MICROS_PER_HOUR;
+    }
+    const int64_t day = floorDiv(timestamp, MICROS_PER_DAY);
+    switch (granularity) {
+        case ROLLUP_WEEK: {
+            const int64_t dayOfWeek = (day + EPOCH_DAY_OF_WEEK) - floorDiv(day + EPOCH_DAY_OF_WEEK, 7) * 7;
+            return (day - dayOfWeek) * MICROS_PER_DAY;
+        }
+        case ROLLUP_MONTH:
+        case ROLLUP_YEAR: {
+            int64_t year, month;
+            civilFromDays(day, year, month);
+            return daysFromCivil(year, granularity == ROLLUP_YEAR ? 1 : month) * MICROS_PER_DAY;
+        }
+        default:
+            return day * MICROS_PER_DAY;
+    }
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "../../../include/datasketches/theta/theta_serde.hpp"
+
+namespace theta_serde {
+
+    CompressedPreamble readCompressedPreamble(const char *data, size_t length) {
+        if (length < 8) {
+            throw std::out_of_range("at least 8 bytes expected, actual " + std::to_string(length));
+        }
+        const uint8_t preambleLongs = data[0];
+        const uint8_t flags = data[5];
+        if (preambleLongs < 1 || preambleLongs > 2 || data[2] != COMPACT_SKETCH_TYPE
+            || (flags & FLAG_BIG_ENDIAN) != 0) {
+            throw std::invalid_argument("malformed compressed theta sketch");
+        }
+
+        CompressedPreamble preamble;
+        preamble.entryBits = data[3];
+        preamble.seedHash = readAt<uint16_t>(data + 6);
+        const uint8_t entryCountBytes = data[4];
+        if (preamble.entryBits > 64 || entryCountBytes > 4) {
+            throw std::invalid_argument("malformed compressed theta sketch");
+        }
+
+        size_t offset = 8;
+        preamble.theta = MAX_THETA;
+        if (preambleLongs > 1) {
+            if (length < offset + 8) {
+                throw std::out_of_range("compressed theta sketch is truncated");
+            }
+            preamble.theta = readAt<uint64_t>(data + offset);
+            offset += 8;
+        }
+        if (length < offset + entryCountBytes) {
+            throw std::out_of_range("compressed theta sketch is truncated");
+        }
+        preamble.numEntries = 0;
+        for (uint8_t i = 0; i < entryCountBytes; i++) {
+            preamble.numEntries |= static_cast<uint32_t>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+        }
+        offset += entryCountBytes;
+
+        preamble.entriesOffset = offset;
+        preamble.entriesBytes = (static_cast<size_t>(preamble.numEntries) * preamble.entryBits + 7) / 8;
+        if (length < offset + preamble.entriesBytes) {
+            throw std::out_of_range("compressed theta sketch is truncated");
+        }
+        return preamble;
+    }
+
+    void unpackCompressedEntries(const char *data, const CompressedPreamble &preamble, uint64_t *entries) {
+        const uint8_t *packed = reinterpret_cast<const uint8_t *>(data + preamble.entriesOffset);
+        const uint8_t bits = preamble.entryBits;
+        const uint32_t numEntries = preamble.numEntries;
+        if (bits == 0) {
+            std::fill(entries, entries + numEntries, 0);
+            return;
+        }
+
+        // Deltas of up to 56 bits fit in one unaligned big endian 64 bits load, whatever their bit offset.
+        // This covers every entry except the last few, whose load would read past the packed bytes.
+        uint32_t i = 0;
+        if (bits <= 56) {
+            for (; i < numEntries; i++) {
+                const size_t position = static_cast<size_t>(i) * bits;
+                if ((position >> 3) + 8 > preamble.entriesBytes) {
+                    break;
+                }
+                const uint64_t word = __builtin_bswap64(readAt<uint64_t>(reinterpret_cast<const char *>(packed)
+                                                                         + (position >> 3)));
+                entries[i] = (word << (position & 7)) >> (64 - bits);
+            }
+        }
+        for (; i < numEntries; i++) {
+            size_t position = static_cast<size_t>(i) * bits;
+            uint64_t value = 0;
+            for (uint8_t remaining = bits; remaining > 0;) {
+                const uint8_t offset = position & 7;
+                const uint8_t take = remaining < 8 - offset ? remaining : 8 - offset;
+                const uint8_t chunk = (packed[position >> 3] >> (8 - offset - take)) & ((1U << take) - 1);
+                value = (value << take) | chunk;
+                position += take;
+                remaining -= take;
+            }
+            entries[i] = value;
+        }
+
+        uint64_t previous = 0;
+        for (i = 0; i < numEntries; i++) {
+            previous += entries[i];
+            entries[i] = previous;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <MurmurHash3.h>
+#include "../../../include/datasketches/theta/theta_serde.hpp"
+#include "../../../include/datasketches/theta/theta_set_ops.hpp"
+
+theta_hashes::theta_hashes() : theta(theta_serde::MAX_THETA), empty(true) {
+}
+
+theta_hashes::theta_hashes(const compact_theta_sketch_custom &sketch)
+        : theta(sketch.get_theta64()), empty(sketch.is_empty()), entries(sketch.begin(), sketch.end()) {
+    if (!sketch.is_ordered()) {
+        std::sort(entries.begin(), entries.end());
+    }
+}
+
+double theta_hashes::getEstimate() const {
+    if (empty) {
+        return 0;
+    }
+    return entries.size() / (static_cast<double>(theta) / theta_serde::MAX_THETA);
+}
+
+void theta_hashes::swap(theta_hashes &other) {
+    std::swap(theta, other.theta);
+    std::swap(empty, other.empty);
+    entries.swap(other.entries);
+}
+
+const uint64_t *theta_hashes_view::endBelow(uint64_t newTheta) const {
+    if (newTheta >= theta) {
+        return end;
+    }
+    return std::lower_bound(begin, end, newTheta);
+}
+
+void thetaUnion(const theta_hashes_view &a, const theta_hashes_view &b, uint32_t k, theta_hashes &out) {
+    out.theta = std::min(a.theta, b.theta);
+    out.empty = a.empty && b.empty;
+    out.entries.clear();
+    const uint64_t *i = a.begin;
+    const uint64_t *j = b.begin;
+    const uint64_t *endA = a.endBelow(out.theta);
+    const uint64_t *endB = b.endBelow(out.theta);
+    out.entries.reserve((endA - i) + (endB - j));
+    while (i < endA && j < endB) {
+        if (*i < *j) {
+            out.entries.push_back(*i++);
+        } else if (*j < *i) {
+            out.entries.push_back(*j++);
+        } else {
+            out.entries.push_back(*i++);
+            j++;
+        }
+    }
+    out.entries.insert(out.entries.end(), i, endA);
+    out.entries.insert(out.entries.end(), j, endB);
+    if (k > 0 && out.entries.size() > k) {
+        out.theta = out.entries[k];
+        out.entries.resize(k);
+    }
+}
+
+void thetaIntersection(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out) {
+    out.theta = std::min(a.theta, b.theta);
+    out.empty = a.empty || b.empty;
+    out.entries.clear();
+    if (out.empty) {
+        return;
+    }
+    const uint64_t *i = a.begin;
+    const uint64_t *j = b.begin;
+    const uint64_t *endA = a.endBelow(out.theta);
+    const uint64_t *endB = b.endBelow(out.theta);
+    while (i < endA && j < endB) {
+        if (*i < *j) {
+            i++;
+        } else if (*j < *i) {
+            j++;
+        } else {
+            out.entries.push_back(*i++);
+            j++;
+        }
+    }
+    // An exact intersection of disjoint sets is the empty set, as theta_intersection returns it.
+    out.empty = out.entries.empty() && out.theta == theta_serde::MAX_THETA;
+}
+
+void thetaANotB(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out) {
+    out.entries.clear();
+    if (a.empty || a.begin == a.end || b.empty) {
+        out.theta = a.theta;
+        out.empty = a.empty;
+        out.entries.insert(out.entries.end(), a.begin, a.end);
+        return;
+    }
+    out.theta = std::min(a.theta, b.theta);
+    const uint64_t *i = a.begin;
+    const uint64_t *j = b.begin;
+    const uint64_t *endA = a.endBelow(out.theta);
+    const uint64_t *endB = b.endBelow(out.theta);
+    while (i < endA) {
+        while (j < endB && *j < *i) {
+            j++;
+        }
+        if (j == endB || *j != *i) {
+            out.entries.push_back(*i);
+        }
+        i++;
+    }
+    out.empty = out.entries.empty() && out.theta == theta_serde::MAX_THETA;
+}
+
+uint64_t thetaHash(const void *data, size_t length, uint64_t seed) {
+    HashState hashes;
+    MurmurHash3_x64_128(data, length, seed, hashes);
+    return hashes.h1 >> 1;
+}
+
+theta_hash_builder::theta_hash_builder(uint32_t k) : k(k) {
+    pending.reserve(k);
+}
+
+void theta_hash_builder::update(uint64_t hash) {
+    // 0 is not a valid hash, as in datasketches, and the sketch stays empty.
+    if (hash == 0) {
+        return;
+    }
+    result.empty = false;
+    if (hash >= result.theta) {
+        return;
+    }
+    pending.push_back(hash);
+    if (pending.size() >= k) {
+        flush();
+    }
+}
+
+void theta_hash_builder::flush() {
+    std::sort(pending.begin(), pending.end());
+    theta_hashes_view added;
+    added.theta = theta_serde::MAX_THETA;
+    added.empty = result.empty;
+    added.begin = pending.data();
+    added.end = pending.data() + (std::unique(pending.begin(), pending.end()) - pending.begin());
+    thetaUnion(theta_hashes_view(result), added, k, scratch);
+    result.swap(scratch);
+    pending.clear();
+}
+
+const theta_hashes &theta_hash_builder::getResult() {
+    if (!pending.empty()) {
+        flush();
+    }
+    return result;
+}
+
+void theta_hash_builder::reset() {
+    theta_hashes().swap(result);
+    pending.clear();
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <atomic>
+#include "../../../include/datasketches/theta/theta_serde.hpp"
+#include "../../../include/datasketches/theta/theta_shards.hpp"
+#include "../../../include/datasketches/workers.hpp"
+
+// Below this many input hashes, starting threads costs more than the merge itself.
+static const size_t SHARDED_MIN_ENTRIES = 1 << 16;
+// Shards per thread, so that a thread with a dense shard does not hold the others up.
+static const unsigned SHARDS_PER_THREAD = 4;
+
+uint32_t thetaShardOf(uint64_t hash, uint8_t lgShards) {
+    return lgShards == 0 ? 0 : static_cast<uint32_t>(hash >> (63 - lgShards));
+}
+
+theta_hashes_view thetaShard(const theta_hashes_view &hashes, uint32_t shard, uint8_t lgShards) {
+    theta_hashes_view view = hashes;
+    if (lgShards == 0) {
+        return view;
+    }
+    const uint64_t first = static_cast<uint64_t>(shard) << (63 - lgShards);
+    const uint64_t last = (static_cast<uint64_t>(shard) + 1) << (63 - lgShards);
+    view.begin = std::lower_bound(hashes.begin, hashes.end, first);
+    view.end = std::lower_bound(view.begin, hashes.end, last);
+    return view;
+}
+
+void thetaConcatenate(const std::vector<theta_hashes_view> &shards, theta_hashes &out) {
+    out.theta = theta_serde::MAX_THETA;
+    out.empty = true;
+    size_t numEntries = 0;
+    for (const theta_hashes_view &shard: shards) {
+        out.theta = std::min(out.theta, shard.theta);
+        out.empty = out.empty && shard.empty;
+        numEntries += shard.end - shard.begin;
+    }
+    out.entries.clear();
+    out.entries.reserve(numEntries);
+    for (const theta_hashes_view &shard: shards) {
+        out.entries.insert(out.entries.end(), shard.begin, shard.endBelow(out.theta));
+    }
+    if (!std::is_sorted(out.entries.begin(), out.entries.end())) {
+        std::sort(out.entries.begin(), out.entries.end());
+        out.entries.erase(std::unique(out.entries.begin(), out.entries.end()), out.entries.end());
+    }
+}
+
+/**
+ * Runs op(shardA, shardB, shardResult) on every shard and concatenates the shard results in out.entries.
+ * Returns false, doing nothing, when the inputs are too small to be worth splitting.
+ */
+template<typename Op>
+static bool shardedEntries(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out,
+                           unsigned numThreads, Op op) {
+    const size_t numEntries = (a.end - a.begin) + (b.end - b.begin);
+    if (numThreads < 2 || numEntries < SHARDED_MIN_ENTRIES) {
+        return false;
+    }
+    uint8_t lgShards = 0;
+    while ((1U << lgShards) < numThreads * SHARDS_PER_THREAD) {
+        lgShards++;
+    }
+    const uint32_t numShards = 1U << lgShards;
+
+    std::vector<theta_hashes> results(numShards);
+    std::atomic<uint32_t> nextShard(0);
+    auto worker = [&]() {
+        for (uint32_t shard = nextShard++; shard < numShards; shard = nextShard++) {
+            op(thetaShard(a, shard, lgShards), thetaShard(b, shard, lgShards), results[shard]);
+        }
+    };
+    runWorkers(numThreads, worker);
+
+    size_t numResults = 0;
+    for (const theta_hashes &result: results) {
+        numResults += result.entries.size();
+    }
+    out.entries.clear();
+    out.entries.reserve(numResults);
+    for (const theta_hashes &result: results) {
+        out.entries.insert(out.entries.end(), result.entries.begin(), result.entries.end());
+    }
+    return true;
+}
+
+void thetaShardedUnion(const theta_hashes_view &a, const theta_hashes_view &b, uint32_t k, theta_hashes &out,
+                       unsigned numThreads) {
+    auto op = [](const theta_hashes_view &shardA, const theta_hashes_view &shardB, theta_hashes &result) {
+        thetaUnion(shardA, shardB, 0, result);
+    };
+    if (!shardedEntries(a, b, out, numThreads, op)) {
+        thetaUnion(a, b, k, out);
+        return;
+    }
+    out.theta = std::min(a.theta, b.theta);
+    out.empty = a.empty && b.empty;
+    if (k > 0 && out.entries.size() > k) {
+        out.theta = out.entries[k];
+        out.entries.resize(k);
+    }
+}
+
+void thetaShardedIntersection(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out,
+                              unsigned numThreads) {
+    if (a.empty || b.empty || !shardedEntries(a, b, out, numThreads, thetaIntersection)) {
+        thetaIntersection(a, b, out);
+        return;
+    }
+    out.theta = std::min(a.theta, b.theta);
+    out.empty = out.entries.empty() && out.theta == theta_serde::MAX_THETA;
+}
+
+void thetaShardedANotB(const theta_hashes_view &a, const theta_hashes_view &b, theta_hashes &out,
+                       unsigned numThreads) {
+    // Without hashes in A or with an empty B, A not B is A itself.
+    if (a.empty || a.begin == a.end || b.empty || !shardedEntries(a, b, out, numThreads, thetaANotB)) {
+        thetaANotB(a, b, out);
+        return;
+    }
+    out.theta = std::min(a.theta, b.theta);
+    out.empty = out.entries.empty() && out.theta == theta_serde::MAX_THETA;
+}
@@ -0,0 +1,45 @@
+#include <Vertica.h>
+#include <cstdlib>
+#include "../../include/datasketches/trace.hpp"
+
+
+static uint8_t clampTraceLevel(long level) {
+    if (level < TRACE_OFF) {
+        return TRACE_OFF;
+    }
+    if (level > TRACE_VERBOSE) {
+        return TRACE_VERBOSE;
+    }
+    return static_cast<uint8_t>(level);
+}
+
+uint8_t defaultTraceLevel() {
+    static const uint8_t level = []() {
+        const char *value = std::getenv(DATASKETCHES_TRACE_LEVEL_ENV_VARIABLE);
+        return value == nullptr ? static_cast<uint8_t>(TRACE_OFF) : clampTraceLevel(std::strtol(value, nullptr, 10));
+    }();
+    return level;
+}
+
+uint8_t readTraceLevel(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_TRACE_LEVEL_PARAMETER_NAME)) {
+        vint level = paramReader.getIntRef(DATASKETCHES_TRACE_LEVEL_PARAMETER_NAME);
+        if (level < TRACE_OFF || level > TRACE_VERBOSE) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_TRACE_LEVEL_PARAMETER_NAME, TRACE_OFF, TRACE_VERBOSE);
+        }
+        return static_cast<uint8_t>(level);
+    }
+    return defaultTraceLevel();
+}
+
+void addTraceLevelParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties traceLevelProps;
+    traceLevelProps.required = false;
+    traceLevelProps.canBeNull = false;
+    traceLevelProps.comment = "Trace level: 0 off, 1 info, 2 debug, 3 verbose.";
+    parameterTypes.addInt(DATASKETCHES_TRACE_LEVEL_PARAMETER_NAME, traceLevelProps);
+}
@@ -0,0 +1,75 @@
+#include "Vertica.h"
+#include <memory>
+#include "../../../include/datasketches/tuple/tuple_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function that builds a tuple sketch of (key, value) rows, summarizing the values of each
+ * key according to the mode parameter, and returns it serialized.
+ * Based on example from https://datasketches.apache.org/docs/Tuple/TupleOverview.html
+ *
+ * The sketch stays live across the blocks of a group and is only serialized at the end of each block.
+ * Keys reads the argument columns and feeds the sketch.
+ */
+template<class Keys>
+class TupleAggregateCreate : public TupleSketchAggregateFunction {
+protected:
+    std::unique_ptr<update_tuple_sketch_custom> sketch;
+    Keys keys;
+
+public:
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        try {
+            sketch.reset(new update_tuple_sketch_custom(update_tuple_sketch_custom::builder(policy)
+                                                                .set_lg_k(logK)
+                                                                .set_seed(seed)
+                                                                .build()));
+            serializeTupleSketch(sketch->compact(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while initializing intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                keys.update(*sketch, argReader);
+            } while (argReader.next());
+            LogTrace(traceLevel, TRACE_VERBOSE, srvInterface, "tuple aggregate: %u retained keys",
+                     sketch->get_num_retained());
+            serializeTupleSketch(sketch->compact(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+template<class Keys>
+class TupleAggregateCreateFactoryBase : public TupleSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        Keys::addArgumentType(argTypes);
+        argTypes.addFloat();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<TupleAggregateCreate<Keys>>(srvfloaterface.allocator);
+    }
+};
+
+class TupleAggregateCreateVarcharFactory : public TupleAggregateCreateFactoryBase<TupleVarcharKeys> {
+};
+
+class TupleAggregateCreateIntFactory : public TupleAggregateCreateFactoryBase<TupleIntKeys> {
+};
+
+RegisterFactory(TupleAggregateCreateVarcharFactory);
+RegisterFactory(TupleAggregateCreateIntFactory);
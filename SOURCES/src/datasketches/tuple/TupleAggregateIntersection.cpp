@@ -0,0 +1,100 @@
+#include "Vertica.h"
+#include "../../../include/datasketches/tuple/tuple_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function intersecting serialized tuple sketches. Summaries of the keys found in all
+ * sketches are merged according to the mode parameter.
+ * The second intermediate tells whether any sketch was seen yet, as an intersection starts from the universe.
+ */
+class TupleAggregateIntersection : public TupleSketchAggregateFunction {
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        vbool &initialized = aggs.getBoolRef(1);
+        initialized = false;
+        TupleSketchAggregateFunction::initAggregate(srvInterface, aggs);
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            tuple_intersection_custom intersection(seed, policy);
+            vbool &initialized = aggs.getBoolRef(1);
+
+            if (initialized) {
+                intersection.update(deserializeTupleSketch(aggs.getStringRef(0).data(),
+                                                           aggs.getStringRef(0).length(), seed));
+            }
+
+            do {
+                const VString &sketch = argReader.getStringRef(0);
+                if (!sketch.isNull()) {
+                    intersection.update(deserializeTupleSketch(sketch.data(), sketch.length(), seed));
+                    initialized = true;
+                }
+            } while (argReader.next());
+
+            if (intersection.has_result()) {
+                serializeTupleSketch(intersection.get_result(), aggs.getStringRef(0));
+            }
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    virtual void combine(ServerInterface &srvInterface,
+                         IntermediateAggs &aggs,
+                         MultipleIntermediateAggs &aggsOther) {
+        try {
+            tuple_intersection_custom intersection(seed, policy);
+            vbool &initialized = aggs.getBoolRef(1);
+            if (initialized) {
+                intersection.update(deserializeTupleSketch(aggs.getStringRef(0).data(),
+                                                           aggs.getStringRef(0).length(), seed));
+            }
+
+            do {
+                vbool otherInitialized = aggsOther.getBoolRef(1);
+                if (otherInitialized) {
+                    intersection.update(deserializeTupleSketch(aggsOther.getStringRef(0).data(),
+                                                               aggsOther.getStringRef(0).length(), seed));
+                    initialized = true;
+                }
+            } while (aggsOther.next());
+
+            if (intersection.has_result()) { // Overwrite empty sketch only if necessary
+                serializeTupleSketch(intersection.get_result(), aggs.getStringRef(0));
+            }
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while combining intermediate aggregates: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+
+class TupleAggregateIntersectionFactory : public TupleSketchAggregateFunctionFactory {
+    virtual void getIntermediateTypes(ServerInterface &srvInterface,
+                                      const SizedColumnTypes &inputTypes,
+                                      SizedColumnTypes &intermediateTypeMetaData) {
+        uint8_t logK = readTupleLogK(srvInterface);
+        intermediateTypeMetaData.addLongVarbinary(tupleSketchMaxSize(logK));
+        intermediateTypeMetaData.addBool();
+    }
+
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<TupleAggregateIntersection>(srvfloaterface.allocator);
+    }
+};
+
+RegisterFactory(TupleAggregateIntersectionFactory);
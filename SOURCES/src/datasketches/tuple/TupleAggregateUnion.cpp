@@ -0,0 +1,57 @@
+#include "Vertica.h"
+#include <memory>
+#include "../../../include/datasketches/tuple/tuple_common.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+/**
+ * User Defined Aggregate Function merging serialized tuple sketches, as returned by tuple_sketch_create.
+ * Summaries of a key found in several sketches are merged according to the mode parameter.
+ * The union stays live across the blocks of a group, like the sketch of tuple_sketch_create.
+ */
+class TupleAggregateUnion : public TupleSketchAggregateFunction {
+protected:
+    std::unique_ptr<tuple_union_custom> u;
+
+public:
+    virtual void initAggregate(ServerInterface &srvInterface, IntermediateAggs &aggs) {
+        TupleSketchAggregateFunction::initAggregate(srvInterface, aggs);
+        u.reset(new tuple_union_custom(tuple_union_custom::builder(policy)
+                                               .set_lg_k(logK)
+                                               .set_seed(seed)
+                                               .build()));
+    }
+
+    void aggregate(ServerInterface &srvInterface,
+                   BlockReader &argReader,
+                   IntermediateAggs &aggs) {
+        try {
+            do {
+                const VString &sketch = argReader.getStringRef(0);
+                if (!sketch.isNull()) {
+                    u->update(deserializeTupleSketch(sketch.data(), sketch.length(), seed));
+                }
+            } while (argReader.next());
+            serializeTupleSketch(u->get_result(), aggs.getStringRef(0));
+        } catch (exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing aggregate: [%s]", e.what());
+        }
+    }
+
+    InlineAggregate()
+};
+
+class TupleAggregateUnionFactory : public TupleSketchAggregateFunctionFactory {
+    virtual void getPrototype(ServerInterface &srvfloaterface, ColumnTypes &argTypes, ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addLongVarbinary();
+    }
+
+    virtual AggregateFunction *createAggregateFunction(ServerInterface &srvfloaterface) {
+        return vt_createFuncObject<TupleAggregateUnion>(srvfloaterface.allocator);
+    }
+};
+
+RegisterFactory(TupleAggregateUnionFactory);
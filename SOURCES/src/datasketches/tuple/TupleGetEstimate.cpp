@@ -0,0 +1,139 @@
+#include <Vertica.h>
+#include <cmath>
+#include "../../../include/datasketches/tuple/tuple_common.hpp"
+
+using namespace Vertica;
+
+class TupleSketchGetEstimate : public TupleSketchScalarFunction {
+public:
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            // While we have inputs to process
+            do {
+                resWriter.setFloat(getSketch(argReader.getStringRef(0))->get_estimate());
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+/**
+ * Statistic over the summaries of a tuple sketch:
+ * - sum: estimated total of the summaries of all distinct keys, the retained sum scaled by 1/theta,
+ * - mean, min, max: over the retained keys, a uniform sample of all keys. NULL for an empty sketch.
+ */
+class TupleSketchGetSummary : public TupleSketchScalarFunction {
+protected:
+    enum Statistic {
+        SUM, MEAN, MIN, MAX
+    };
+
+    Statistic statistic;
+
+public:
+    virtual void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) {
+        TupleSketchScalarFunction::setup(srvInterface, argTypes);
+        ParamReader paramReader = srvInterface.getParamReader();
+        statistic = SUM;
+        if (paramReader.containsParameter(DATASKETCHES_TUPLE_STATISTIC_PARAMETER_NAME)) {
+            const std::string name = paramReader.getStringRef(DATASKETCHES_TUPLE_STATISTIC_PARAMETER_NAME).str();
+            if (name == "mean") {
+                statistic = MEAN;
+            } else if (name == "min") {
+                statistic = MIN;
+            } else if (name == "max") {
+                statistic = MAX;
+            } else if (name != "sum") {
+                vt_report_error(2, "Provided value of the %s parameter is not supported. "
+                                   "The value should be sum, mean, min or max",
+                                DATASKETCHES_TUPLE_STATISTIC_PARAMETER_NAME);
+            }
+        }
+    }
+
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) {
+        try {
+            cache.newBlock();
+            do {
+                auto sketch = getSketch(argReader.getStringRef(0));
+                if (statistic != SUM && sketch->get_num_retained() == 0) {
+                    resWriter.setFloat(vfloat_null);
+                } else {
+                    double sum = 0;
+                    double min = INFINITY;
+                    double max = -INFINITY;
+                    for (const auto &entry: *sketch) {
+                        sum += entry.second;
+                        min = entry.second < min ? entry.second : min;
+                        max = entry.second > max ? entry.second : max;
+                    }
+                    switch (statistic) {
+                        case MEAN:
+                            resWriter.setFloat(sum / sketch->get_num_retained());
+                            break;
+                        case MIN:
+                            resWriter.setFloat(min);
+                            break;
+                        case MAX:
+                            resWriter.setFloat(max);
+                            break;
+                        default:
+                            resWriter.setFloat(sum / sketch->get_theta());
+                    }
+                }
+                resWriter.next();
+            } while (argReader.next());
+        } catch (std::exception &e) {
+            // Standard exception. Quit.
+            vt_report_error(0, "Exception while processing block: [%s]", e.what());
+        }
+    }
+};
+
+template<class Function>
+class TupleSketchScalarFactoryBase : public ScalarFunctionFactory {
+    virtual ScalarFunction *createScalarFunction(ServerInterface &interface) {
+        return vt_createFuncObject<Function>(interface.allocator);
+    }
+
+    virtual void getPrototype(ServerInterface &interface,
+                              ColumnTypes &argTypes,
+                              ColumnTypes &returnType) {
+        argTypes.addLongVarbinary();
+        returnType.addFloat();
+    }
+
+protected:
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        addSeedParameter(parameterTypes);
+        addCacheSizeParameter(parameterTypes);
+        addTraceLevelParameter(parameterTypes);
+    }
+};
+
+class TupleSketchGetEstimateFactory : public TupleSketchScalarFactoryBase<TupleSketchGetEstimate> {
+};
+
+class TupleSketchGetSummaryFactory : public TupleSketchScalarFactoryBase<TupleSketchGetSummary> {
+    virtual void getParameterType(ServerInterface &srvInterface,
+                                  SizedColumnTypes &parameterTypes) {
+        TupleSketchScalarFactoryBase<TupleSketchGetSummary>::getParameterType(srvInterface, parameterTypes);
+        SizedColumnTypes::Properties statisticProps;
+        statisticProps.required = false;
+        statisticProps.canBeNull = false;
+        statisticProps.comment = "Statistic of the summaries: sum (default), mean, min or max.";
+        parameterTypes.addVarchar(4, DATASKETCHES_TUPLE_STATISTIC_PARAMETER_NAME, statisticProps);
+    }
+};
+
+RegisterFactory(TupleSketchGetEstimateFactory);
+RegisterFactory(TupleSketchGetSummaryFactory);
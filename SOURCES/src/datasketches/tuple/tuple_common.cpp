@@ -0,0 +1,58 @@
+#include <Vertica.h>
+#include <algorithm>
+#include "../../../include/datasketches/tuple/tuple_common.hpp"
+
+
+uint8_t readTupleLogK(ServerInterface &serverInterface) {
+    vint logK;
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (paramReader.containsParameter(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME)) {
+        logK = paramReader.getIntRef(DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME);
+        if (logK < DATASKETCHES_TUPLE_LOG_K_MIN || logK > DATASKETCHES_TUPLE_LOG_K_MAX) {
+            vt_report_error(2,
+                            "Provided value of the %s parameter is not supported. The value should be between %d and %d, inclusive",
+                            DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, DATASKETCHES_TUPLE_LOG_K_MIN,
+                            DATASKETCHES_TUPLE_LOG_K_MAX);
+        }
+    } else {
+        LogDebugUDxWarn(serverInterface, "Parameter %s was not provided. Defaulting to %d",
+                        DATASKETCHES_LOG_NOMINAL_VALUE_PARAMETER_NAME, DATASKETCHES_TUPLE_LOG_K_DEFAULT);
+        logK = DATASKETCHES_TUPLE_LOG_K_DEFAULT;
+    }
+    return logK;
+}
+
+double_summary_policy::mode readTupleMode(ServerInterface &serverInterface) {
+    ParamReader paramReader = serverInterface.getParamReader();
+
+    if (!paramReader.containsParameter(DATASKETCHES_TUPLE_MODE_PARAMETER_NAME)) {
+        return double_summary_policy::SUM;
+    }
+    const std::string mode = paramReader.getStringRef(DATASKETCHES_TUPLE_MODE_PARAMETER_NAME).str();
+    if (mode == "sum") {
+        return double_summary_policy::SUM;
+    }
+    if (mode == "min") {
+        return double_summary_policy::MIN;
+    }
+    if (mode == "max") {
+        return double_summary_policy::MAX;
+    }
+    vt_report_error(2, "Provided value of the %s parameter is not supported. The value should be sum, min or max",
+                    DATASKETCHES_TUPLE_MODE_PARAMETER_NAME);
+    return double_summary_policy::SUM;
+}
+
+void addTupleModeParameter(SizedColumnTypes &parameterTypes) {
+    SizedColumnTypes::Properties modeProps;
+    modeProps.required = false;
+    modeProps.canBeNull = false;
+    modeProps.comment = "How the values of a key are summarized: sum (default), min or max.";
+    parameterTypes.addVarchar(3, DATASKETCHES_TUPLE_MODE_PARAMETER_NAME, modeProps);
+}
+
+uint32_t tupleSketchMaxSize(uint8_t logK) {
+    const uint64_t size = 24 + (2ULL << logK) * (sizeof(uint64_t) + sizeof(double));
+    return std::min<uint64_t>(size, DATASKETCHES_TUPLE_MAX_SERIALIZED_SIZE);
+}
@@ -0,0 +1,43 @@
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../../include/datasketches/workers.hpp"
+
+
+void runWorkers(unsigned numThreads, const std::function<void()> &worker) {
+    std::mutex mutex;
+    std::exception_ptr error;
+    auto keepError = [&mutex, &error]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    };
+    auto guardedWorker = [&worker, &keepError]() {
+        try {
+            worker();
+        } catch (...) {
+            keepError();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    try {
+        threads.reserve(numThreads);
+        for (unsigned t = 1; t < numThreads; t++) {
+            threads.emplace_back(guardedWorker);
+        }
+    } catch (...) {
+        keepError();
+    }
+    if (!error) {
+        guardedWorker();
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
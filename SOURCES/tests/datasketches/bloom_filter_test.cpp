@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "datasketches/bloom/bloom_filter.hpp"
+#include "datasketches/seed_hash.hpp"
+#include "test_common.hpp"
+
+/**
+ * Bloom filters have no false negatives, keep about their false positive probability when filled to their number
+ * of items, and merge into the filter of the union.
+ */
+
+static const uint64_t SEED = 9001;
+static const uint16_t SEED_HASH = computeSeedHash(SEED);
+
+static HashState hashOf(uint64_t value) {
+    return bloom_filter::hash(&value, sizeof(value), SEED);
+}
+
+static std::vector<char> emptyFilter(uint32_t numBlocks) {
+    std::vector<char> bytes(bloom_filter::getSerializedSize(numBlocks));
+    bloom_filter::initialize(bytes.data(), numBlocks, SEED_HASH);
+    return bytes;
+}
+
+static void checkFalsePositives() {
+    const uint64_t numItems = 200000;
+    for (double fpp: {0.1, 0.01, 0.001}) {
+        const uint64_t numBlocks = bloom_filter::numBlocksFor(numItems, fpp);
+        // Filled in two halves then merged, as combine() does.
+        std::vector<char> bytes = emptyFilter(numBlocks);
+        std::vector<char> otherBytes = emptyFilter(numBlocks);
+        bloom_filter filter(bytes.data(), bytes.size(), SEED_HASH);
+        bloom_filter other(otherBytes.data(), otherBytes.size(), SEED_HASH);
+        CHECK(filter.getNumBlocks() == numBlocks);
+        for (uint64_t value = 0; value < numItems; value++) {
+            (value % 2 == 0 ? filter : other).insert(hashOf(value));
+        }
+        filter.merge(other);
+
+        bool falseNegative = false;
+        for (uint64_t value = 0; value < numItems; value++) {
+            falseNegative = falseNegative || !filter.contains(hashOf(value));
+        }
+        CHECK(!falseNegative);
+
+        const uint64_t numProbes = 1000000;
+        uint64_t falsePositives = 0;
+        for (uint64_t value = numItems; value < numItems + numProbes; value++) {
+            falsePositives += filter.contains(hashOf(value));
+        }
+        const double measured = static_cast<double>(falsePositives) / numProbes;
+        CHECK(measured <= 1.5 * fpp);
+        // Not oversized either.
+        CHECK(measured >= fpp / 4);
+    }
+}
+
+static void checkValidation() {
+    std::vector<char> bytes = emptyFilter(4);
+    CHECK_THROWS(std::invalid_argument, bloom_filter(bytes.data(), bytes.size(), computeSeedHash(SEED + 1)));
+    CHECK_THROWS(std::invalid_argument, bloom_filter(bytes.data(), bytes.size() - 1, SEED_HASH));
+    CHECK_THROWS(std::invalid_argument, bloom_filter(bytes.data(), 3, SEED_HASH));
+    std::vector<char> otherBytes = emptyFilter(8);
+    bloom_filter filter(bytes.data(), bytes.size(), SEED_HASH);
+    bloom_filter other(otherBytes.data(), otherBytes.size(), SEED_HASH);
+    CHECK_THROWS(std::invalid_argument, filter.merge(other));
+
+    // Filters are used in place, whatever the alignment of their bytes.
+    std::vector<char> shifted(bloom_filter::getSerializedSize(4) + 1);
+    bloom_filter::initialize(shifted.data() + 1, 4, SEED_HASH);
+    bloom_filter unaligned(shifted.data() + 1, shifted.size() - 1, SEED_HASH);
+    CHECK(!unaligned.contains(hashOf(42)));
+    unaligned.insert(hashOf(42));
+    CHECK(unaligned.contains(hashOf(42)));
+    CHECK(bloom_filter(shifted.data() + 1, shifted.size() - 1, SEED_HASH).contains(hashOf(42)));
+}
+
+int main() {
+    checkFalsePositives();
+    checkValidation();
+    return testResult();
+}
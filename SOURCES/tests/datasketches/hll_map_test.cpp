@@ -0,0 +1,75 @@
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "datasketches/hll/hll_map.hpp"
+#include "test_common.hpp"
+
+/**
+ * hll_map counts against exact counts, through all the stages of a key: inline coupons, coupon sets and HLL.
+ */
+
+static void update(hll_map &map, const std::string &key, uint64_t value) {
+    map.update(key.data(), key.size(), &value, sizeof(value));
+}
+
+static double estimate(const hll_map &map, const std::string &key) {
+    return map.getEstimate(key.data(), key.size());
+}
+
+int main() {
+    // Starting small makes the table grow several times.
+    hll_map map(2);
+    std::map<std::string, uint64_t> counts;
+    const uint64_t sizes[] = {1, 2, 3, 8, 9, 100, 192, 193, 1000, 20000};
+    for (int key = 0; key < 3000; key++) {
+        counts["key" + std::to_string(key)] = sizes[key % 10];
+    }
+    counts[""] = 5;
+    for (const auto &count: counts) {
+        for (uint64_t value = 0; value < count.second; value++) {
+            update(map, count.first, value);
+            // Duplicates never count.
+            if (value % 3 == 0) {
+                update(map, count.first, value);
+            }
+        }
+    }
+
+    CHECK(map.getNumKeys() == counts.size());
+    double squaredErrors = 0;
+    size_t numLarge = 0;
+    for (const auto &count: counts) {
+        const double actual = count.second;
+        const double error = estimate(map, count.first) - actual;
+        if (count.second <= 192) {
+            // Exact below the HLL stage, up to a rare coupon collision.
+            CHECK(std::fabs(error) <= 1);
+        } else {
+            CHECK(std::fabs(error) < 0.12 * actual);
+            squaredErrors += (error / actual) * (error / actual);
+            numLarge++;
+        }
+    }
+    // HLL keys are documented at about 2.6% relative error.
+    CHECK(std::sqrt(squaredErrors / numLarge) < 0.04);
+
+    size_t visited = 0;
+    map.forEach([&](const char *key, size_t keyLength, double value) {
+        const std::string name(key, keyLength);
+        CHECK(counts.count(name) == 1);
+        CHECK(value == estimate(map, name));
+        visited++;
+    });
+    CHECK(visited == counts.size());
+
+    CHECK(estimate(map, "missing") == 0);
+    // Empty values are ignored, as in datasketches.
+    const std::string key = "key0";
+    const double before = estimate(map, key);
+    map.update(key.data(), key.size(), "", 0);
+    CHECK(estimate(map, key) == before);
+    CHECK(map.getMemoryUsage() > 0);
+
+    return testResult();
+}
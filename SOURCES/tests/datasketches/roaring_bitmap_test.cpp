@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include "datasketches/bitmap/roaring_bitmap.hpp"
+#include "test_common.hpp"
+
+/**
+ * Roaring bitmaps hold the same sets as std::set through additions, set operations and serialization, whether their
+ * containers are arrays or bitmaps.
+ */
+
+typedef std::set<uint64_t> value_set;
+
+/**
+ * Adds the values in sorted chunks of random sizes given in random order, as rows come to update().
+ */
+static roaring_bitmap inChunks(const value_set &values, std::mt19937_64 &random) {
+    std::vector<uint64_t> shuffled(values.begin(), values.end());
+    std::shuffle(shuffled.begin(), shuffled.end(), random);
+    roaring_bitmap bitmap;
+    for (size_t position = 0; position < shuffled.size();) {
+        const size_t size = std::min<size_t>(shuffled.size() - position, 1 + random() % 20000);
+        std::vector<uint64_t> chunk(shuffled.begin() + position, shuffled.begin() + position + size);
+        std::sort(chunk.begin(), chunk.end());
+        bitmap.addSorted(chunk.data(), chunk.data() + chunk.size());
+        position += size;
+    }
+    return bitmap;
+}
+
+static roaring_bitmap atOnce(const value_set &values) {
+    const std::vector<uint64_t> sorted(values.begin(), values.end());
+    roaring_bitmap bitmap;
+    bitmap.addSorted(sorted.data(), sorted.data() + sorted.size());
+    return bitmap;
+}
+
+/**
+ * Checks bitmap against values, before and after a serialization round trip.
+ */
+static void checkHolds(const roaring_bitmap &bitmap, const value_set &values) {
+    std::vector<char> bytes(bitmap.getSerializedSize());
+    CHECK(bitmap.serialize(bytes.data()) == bytes.size());
+    CHECK(roaring_bitmap::readCardinality(bytes.data(), bytes.size()) == values.size());
+    const roaring_bitmap deserialized = roaring_bitmap::deserialize(bytes.data(), bytes.size());
+    CHECK(bitmap.getCardinality() == values.size());
+    CHECK(deserialized.getCardinality() == values.size());
+
+    // Same cardinality and nothing left out either way.
+    const roaring_bitmap expected = atOnce(values);
+    roaring_bitmap extra, missing;
+    roaring_bitmap::andNot(deserialized, expected, extra);
+    roaring_bitmap::andNot(expected, deserialized, missing);
+    CHECK(extra.getCardinality() == 0 && missing.getCardinality() == 0);
+}
+
+/**
+ * Values spread so that containers are sparse arrays, dense arrays, bitmaps, or a mix.
+ */
+static value_set randomValues(std::mt19937_64 &random, int spread) {
+    value_set values;
+    const size_t numValues = random() % 50000;
+    for (size_t i = 0; i < numValues; i++) {
+        switch (spread) {
+            case 0:
+                values.insert(random() % 300000);
+                break;
+            case 1:
+                values.insert(random() % 5000000);
+                break;
+            case 2:
+                values.insert(random());
+                break;
+            default:
+                values.insert((random() % 4) << 16 | random() % 65536);
+        }
+    }
+    return values;
+}
+
+static void checkSetOperations(std::mt19937_64 &random) {
+    for (int trial = 0; trial < 32; trial++) {
+        const value_set a = randomValues(random, trial % 4);
+        const value_set b = randomValues(random, (trial / 4) % 4);
+        const roaring_bitmap bitmapA = inChunks(a, random);
+        const roaring_bitmap bitmapB = inChunks(b, random);
+        checkHolds(bitmapA, a);
+
+        value_set expected = a;
+        expected.insert(b.begin(), b.end());
+        roaring_bitmap result = bitmapA;
+        result.unionWith(bitmapB);
+        checkHolds(result, expected);
+
+        expected.clear();
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+        roaring_bitmap::intersection(bitmapA, bitmapB, result);
+        checkHolds(result, expected);
+
+        expected.clear();
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+        roaring_bitmap::andNot(bitmapA, bitmapB, result);
+        checkHolds(result, expected);
+
+        result = bitmapA;
+        result.unionWith(result);
+        checkHolds(result, a);
+    }
+}
+
+static void checkMalformed() {
+    const roaring_bitmap empty;
+    std::vector<char> bytes(empty.getSerializedSize());
+    empty.serialize(bytes.data());
+    CHECK(roaring_bitmap::deserialize(bytes.data(), bytes.size()).getCardinality() == 0);
+    CHECK_THROWS(std::invalid_argument, roaring_bitmap::deserialize(bytes.data(), 3));
+
+    value_set values;
+    for (uint64_t value = 0; value < 10000; value += 3) {
+        values.insert(value);
+    }
+    const roaring_bitmap bitmap = atOnce(values);
+    bytes.resize(bitmap.getSerializedSize());
+    bitmap.serialize(bytes.data());
+    CHECK_THROWS(std::invalid_argument, roaring_bitmap::deserialize(bytes.data(), bytes.size() - 1));
+    bytes[1] = 'T';
+    CHECK_THROWS(std::invalid_argument, roaring_bitmap::deserialize(bytes.data(), bytes.size()));
+}
+
+int main() {
+    std::mt19937_64 random(42);
+    checkSetOperations(random);
+    checkMalformed();
+    return testResult();
+}
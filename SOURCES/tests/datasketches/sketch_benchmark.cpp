@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cpc_sketch.hpp>
+#include <cpc_union.hpp>
+#include <hll.hpp>
+#include "datasketches/theta/theta_const.hpp"
+#include "datasketches/theta/theta_def.hpp"
+
+using namespace std;
+using namespace datasketches;
+
+/**
+ * Compares theta, HLL and CPC sketches configured for about the same error (1.5% - 1.6% relative standard error
+ * once merged): serialized size and merge throughput (deserialize + union of serialized sketches), as our functions
+ * do in combine() and in the union aggregates. The error column is the error of that one merge, not an average.
+ *
+ * Usage: sketch_benchmark [sketches per run, default 1000]
+ */
+
+struct Family {
+    string name;
+    // Builds a sketch of the values [start, start + count) and returns it serialized.
+    function<vector<uint8_t>(uint64_t start, uint64_t count)> build;
+    // Merges serialized sketches and returns the estimate of the union.
+    function<double(const vector<vector<uint8_t>> &sketches)> merge;
+};
+
+static vector<Family> families() {
+    vector<Family> result;
+    result.push_back(Family{
+            "theta lgK=12",
+            [](uint64_t start, uint64_t count) {
+                auto sketch = update_theta_sketch_custom::builder().set_lg_k(12).build();
+                for (uint64_t i = start; i < start + count; i++) sketch.update(i);
+                auto bytes = sketch.compact().serialize();
+                return vector<uint8_t>(bytes.begin(), bytes.end());
+            },
+            [](const vector<vector<uint8_t>> &sketches) {
+                auto u = theta_union_custom::builder().set_lg_k(12).build();
+                for (auto &bytes: sketches) u.update(compact_theta_sketch_custom::deserialize(bytes.data(), bytes.size()));
+                return u.get_result().get_estimate();
+            }});
+    for (auto type: {HLL_4, HLL_8}) {
+        result.push_back(Family{
+                type == HLL_4 ? "hll_4 lgK=12" : "hll_8 lgK=12",
+                [type](uint64_t start, uint64_t count) {
+                    hll_sketch sketch(12, type);
+                    for (uint64_t i = start; i < start + count; i++) sketch.update(i);
+                    auto bytes = sketch.serialize_compact();
+                    return vector<uint8_t>(bytes.begin(), bytes.end());
+                },
+                [type](const vector<vector<uint8_t>> &sketches) {
+                    hll_union u(12);
+                    for (auto &bytes: sketches) u.update(hll_sketch::deserialize(bytes.data(), bytes.size()));
+                    return u.get_result(type).get_estimate();
+                }});
+    }
+    result.push_back(Family{
+            "cpc lgK=11",
+            [](uint64_t start, uint64_t count) {
+                cpc_sketch sketch(11);
+                for (uint64_t i = start; i < start + count; i++) sketch.update(i);
+                auto bytes = sketch.serialize();
+                return vector<uint8_t>(bytes.begin(), bytes.end());
+            },
+            [](const vector<vector<uint8_t>> &sketches) {
+                cpc_union u(11);
+                for (auto &bytes: sketches) u.update(cpc_sketch::deserialize(bytes.data(), bytes.size()));
+                return u.get_result().get_estimate();
+            }});
+    return result;
+}
+
+int main(int argc, char **argv) {
+    const size_t numSketches = argc > 1 ? stoul(argv[1]) : 1000;
+
+    printf("%-14s %12s %12s %14s %12s\n", "sketch", "distinct", "avg bytes", "merges/s", "merged err");
+    for (const Family &family: families()) {
+        for (uint64_t distinct: {1000ULL, 100000ULL, 10000000ULL}) {
+            // Disjoint inputs, each with distinct / numSketches values, so that the union holds distinct values.
+            const uint64_t perSketch = max<uint64_t>(1, distinct / numSketches);
+            vector<vector<uint8_t>> sketches;
+            size_t totalBytes = 0;
+            for (size_t i = 0; i < numSketches; i++) {
+                sketches.push_back(family.build(i * perSketch, perSketch));
+                totalBytes += sketches.back().size();
+            }
+
+            auto start = chrono::steady_clock::now();
+            const double estimate = family.merge(sketches);
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            const double actual = static_cast<double>(perSketch * numSketches);
+            printf("%-14s %12.0f %12zu %14.0f %11.2f%%\n", family.name.c_str(), actual, totalBytes / numSketches,
+                   numSketches / seconds, 100 * (estimate - actual) / actual);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include "datasketches/sliding_window.hpp"
+#include "test_common.hpp"
+
+/**
+ * two_stack_window against the direct union of the last panes. Panes are lists and unions concatenations, so that
+ * the order of the operands of combine() is checked as well.
+ */
+
+struct ConcatenationOps {
+    typedef std::vector<int> value_type;
+
+    mutable size_t numCombines = 0;
+
+    value_type combine(const value_type &older, const value_type &newer) const {
+        numCombines++;
+        value_type result(older);
+        result.insert(result.end(), newer.begin(), newer.end());
+        return result;
+    }
+};
+
+int main() {
+    std::mt19937 random(1);
+    for (size_t window = 1; window <= 12; window++) {
+        ConcatenationOps ops;
+        two_stack_window<ConcatenationOps> panes(ops);
+        std::vector<std::vector<int>> pushed;
+        const size_t numPanes = 300;
+        for (size_t i = 0; i < numPanes; i++) {
+            std::vector<int> pane;
+            const size_t paneSize = random() % 4;
+            for (size_t j = 0; j < paneSize; j++) {
+                pane.push_back(static_cast<int>(random() % 1000));
+            }
+            pushed.push_back(pane);
+            panes.push(std::move(pane));
+            if (panes.size() > window) {
+                panes.pop();
+            }
+            CHECK(panes.size() == std::min(window, i + 1));
+
+            std::vector<int> expected;
+            for (size_t k = i + 1 - panes.size(); k <= i; k++) {
+                expected.insert(expected.end(), pushed[k].begin(), pushed[k].end());
+            }
+            CHECK(panes.query() == expected);
+        }
+        // About 3 unions per pane, queries included, whatever the window.
+        CHECK(ops.numCombines <= 3 * numPanes);
+    }
+    return testResult();
+}
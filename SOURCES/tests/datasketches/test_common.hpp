@@ -0,0 +1,42 @@
+#ifndef VERTICA_UDFS_TEST_COMMON_HPP
+#define VERTICA_UDFS_TEST_COMMON_HPP
+
+#include <cstdio>
+
+/**
+ * Minimal checks for the behavior tests: failures are reported and counted, and main() returns testResult() so that
+ * ctest sees them.
+ */
+static int testFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_THROWS(exception, statement) \
+    do { \
+        bool thrown = false; \
+        try { \
+            statement; \
+        } catch (const exception &) { \
+            thrown = true; \
+        } \
+        if (!thrown) { \
+            std::fprintf(stderr, "%s:%d: %s did not throw %s\n", __FILE__, __LINE__, #statement, #exception); \
+            testFailures++; \
+        } \
+    } while (0)
+
+inline int testResult() {
+    if (testFailures > 0) {
+        std::fprintf(stderr, "%d checks failed\n", testFailures);
+        return 1;
+    }
+    return 0;
+}
+
+#endif //VERTICA_UDFS_TEST_COMMON_HPP
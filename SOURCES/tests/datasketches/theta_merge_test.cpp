@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+#include "datasketches/theta/theta_merge.hpp"
+#include "datasketches/theta/theta_serde.hpp"
+#include "test_common.hpp"
+#include "theta_test_sketch.hpp"
+
+/**
+ * ordered_theta_merge against the union of the hashes of its inputs: the k smallest distinct hashes below the
+ * minimum theta of the non empty inputs.
+ */
+
+static const uint64_t SEED = 9001;
+
+static void checkRandomMerges(std::mt19937_64 &random) {
+    const uint16_t seedHash = computeSeedHash(SEED);
+    for (int trial = 0; trial < 300; trial++) {
+        const uint8_t logK = 5 + random() % 5;
+        const size_t k = 1U << logK;
+        const int numInputs = 1 + random() % 20;
+        ordered_theta_merge merge(logK, SEED);
+        std::vector<std::vector<char>> inputs;
+        std::set<uint64_t> all;
+        uint64_t theta = theta_serde::MAX_THETA;
+        bool empty = true;
+        for (int i = 0; i < numInputs; i++) {
+            if (random() % 5 == 0) {
+                // Empty sketches do not contribute, not even their theta.
+                inputs.push_back(theta_test_sketch({}, random() >> 1, true, seedHash).serializeCompact());
+                continue;
+            }
+            const uint64_t inputTheta = random() % 3 == 0 ? random() >> 2 : theta_serde::MAX_THETA;
+            std::set<uint64_t> hashes;
+            const size_t numHashes = random() % (3 * k);
+            // Hashes from a small range, for overlapping inputs.
+            while (hashes.size() < numHashes) {
+                hashes.insert(1 + (random() >> 1) % (theta_serde::MAX_THETA / 1000));
+            }
+            theta_test_sketch input(hashes, inputTheta, false, seedHash);
+            all.insert(input.begin(), input.end());
+            theta = std::min(theta, inputTheta);
+            empty = false;
+            inputs.push_back(input.serializeCompact());
+        }
+        for (const std::vector<char> &input: inputs) {
+            merge.add(input.data(), input.size());
+        }
+        CHECK(merge.canMerge());
+        CHECK(merge.getInputs().size() == inputs.size());
+
+        std::set<uint64_t> expected;
+        for (uint64_t hash: all) {
+            if (hash < theta) {
+                expected.insert(hash);
+            }
+        }
+        if (expected.size() > k) {
+            auto kth = expected.begin();
+            std::advance(kth, k);
+            theta = *kth;
+            expected.erase(kth, expected.end());
+        }
+        std::vector<char> result(merge.getMaxSerializedSize());
+        result.resize(merge.serializeTo(result.data()));
+        CHECK(result == theta_test_sketch(expected, theta, empty, seedHash).serializeCompact());
+    }
+}
+
+static void checkFallbacks() {
+    const uint16_t seedHash = computeSeedHash(SEED);
+    const std::set<uint64_t> hashes = {10, 20, 30};
+    ordered_theta_merge merge(5, SEED);
+
+    std::vector<char> unordered = theta_test_sketch(hashes, theta_serde::MAX_THETA, false, seedHash).serializeCompact();
+    unordered[5] &= ~theta_serde::FLAG_ORDERED;
+    merge.add(unordered.data(), unordered.size());
+    CHECK(!merge.canMerge());
+
+    merge.reset();
+    CHECK(merge.canMerge());
+    CHECK(merge.getInputs().empty());
+    const std::vector<char> otherSeed = theta_test_sketch(hashes, theta_serde::MAX_THETA, false,
+                                                          computeSeedHash(SEED + 1)).serializeCompact();
+    merge.add(otherSeed.data(), otherSeed.size());
+    CHECK(!merge.canMerge());
+
+    merge.reset();
+    std::set<uint64_t> spread;
+    for (uint64_t i = 1; i <= 100; i++) {
+        spread.insert(i << 40);
+    }
+    const theta_test_sketch sketch(spread, theta_serde::MAX_THETA, false, seedHash);
+    std::vector<char> compressed(compressedThetaSerializedSize(sketch));
+    compressed.resize(serializeCompressedTheta(sketch, compressed.data()));
+    CHECK(theta_serde::isCompressed(compressed.data(), compressed.size()));
+    merge.add(compressed.data(), compressed.size());
+    CHECK(!merge.canMerge());
+    CHECK(merge.getInputs().size() == 1);
+
+    merge.reset();
+    merge.add(compressed.data(), 3);
+    CHECK(!merge.canMerge());
+}
+
+int main() {
+    std::mt19937_64 random(1);
+    checkRandomMerges(random);
+    checkFallbacks();
+    return testResult();
+}
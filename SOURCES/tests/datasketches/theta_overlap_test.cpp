@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "datasketches/theta/theta_overlap.hpp"
+#include "datasketches/theta/theta_serde.hpp"
+#include "datasketches/workers.hpp"
+#include "test_common.hpp"
+
+/**
+ * theta_overlap against pairwise intersections of std::set, for any number of threads, and the worker threads it
+ * runs on.
+ */
+
+static std::vector<theta_hashes> randomSketches(std::mt19937_64 &random, size_t numSketches) {
+    std::vector<theta_hashes> sketches(numSketches);
+    for (theta_hashes &sketch: sketches) {
+        sketch.empty = false;
+        sketch.theta = random() % 2 == 0 ? theta_serde::MAX_THETA : 500 + random() % 500;
+        std::set<uint64_t> hashes;
+        const size_t numHashes = random() % 300;
+        for (size_t i = 0; i < numHashes; i++) {
+            const uint64_t hash = 1 + random() % 1000;
+            if (hash < sketch.theta) {
+                hashes.insert(hash);
+            }
+        }
+        sketch.entries.assign(hashes.begin(), hashes.end());
+    }
+    return sketches;
+}
+
+static void checkOverlaps(std::mt19937_64 &random) {
+    // Around the tile size, for partial tiles.
+    for (size_t numSketches: {0, 1, 2, 31, 32, 33, 70}) {
+        const std::vector<theta_hashes> sketches = randomSketches(random, numSketches);
+        for (unsigned numThreads: {1, 3, 8}) {
+            theta_overlap overlap(sketches);
+            overlap.compute(numThreads);
+            for (size_t i = 0; i < numSketches; i++) {
+                for (size_t j = i + 1; j < numSketches; j++) {
+                    const uint64_t theta = std::min(sketches[i].theta, sketches[j].theta);
+                    const std::set<uint64_t> a(sketches[i].entries.begin(),
+                                               std::lower_bound(sketches[i].entries.begin(),
+                                                                sketches[i].entries.end(), theta));
+                    const std::set<uint64_t> b(sketches[j].entries.begin(),
+                                               std::lower_bound(sketches[j].entries.begin(),
+                                                                sketches[j].entries.end(), theta));
+                    size_t common = 0;
+                    for (uint64_t hash: a) {
+                        common += b.count(hash);
+                    }
+                    const size_t either = a.size() + b.size() - common;
+                    const double estimate = common / (static_cast<double>(theta) / theta_serde::MAX_THETA);
+                    CHECK(std::fabs(overlap.getIntersectionEstimate(i, j) - estimate) <= 1e-9 * estimate);
+                    CHECK(overlap.getJaccard(i, j) == (either == 0 ? 1.0 : static_cast<double>(common) / either));
+                }
+            }
+        }
+    }
+}
+
+static void checkWorkers() {
+    for (unsigned numThreads: {1, 2, 8}) {
+        std::atomic<unsigned> calls(0);
+        const std::thread::id caller = std::this_thread::get_id();
+        std::atomic<bool> ranOnCaller(false);
+        runWorkers(numThreads, [&]() {
+            calls++;
+            if (std::this_thread::get_id() == caller) {
+                ranOnCaller = true;
+            }
+        });
+        CHECK(calls == numThreads);
+        CHECK(ranOnCaller);
+
+        // The exception of a worker reaches the caller once every worker is done.
+        std::atomic<unsigned> started(0);
+        std::atomic<unsigned> finished(0);
+        CHECK_THROWS(std::runtime_error, runWorkers(numThreads, [&]() {
+            if (started++ == numThreads - 1) {
+                throw std::runtime_error("worker failed");
+            }
+            finished++;
+        }));
+        CHECK(started == numThreads);
+        CHECK(finished == numThreads - 1);
+    }
+}
+
+int main() {
+    std::mt19937_64 random(3);
+    checkOverlaps(random);
+    checkWorkers();
+    return testResult();
+}
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <ctime>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "datasketches/theta/theta_rollup.hpp"
+#include "test_common.hpp"
+
+/**
+ * Rollup buckets against the C library calendar. Timestamps are Vertica TIMESTAMP values: microseconds since
+ * 2000-01-01 00:00:00 UTC.
+ */
+
+static const int64_t MICROS_PER_SECOND = 1000000;
+static const int64_t UNIX_SECONDS_AT_2000 = 946684800;
+
+static int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+static int64_t referenceBucketStart(int64_t timestamp, rollup_granularity granularity) {
+    const time_t seconds = floorDiv(timestamp, MICROS_PER_SECOND) + UNIX_SECONDS_AT_2000;
+    struct tm date;
+    gmtime_r(&seconds, &date);
+    date.tm_sec = 0;
+    date.tm_min = 0;
+    if (granularity != ROLLUP_HOUR) {
+        date.tm_hour = 0;
+    }
+    if (granularity == ROLLUP_WEEK) {
+        // ISO weeks start on Monday, timegm normalizes days before the 1st.
+        date.tm_mday -= (date.tm_wday + 6) % 7;
+    }
+    if (granularity == ROLLUP_MONTH || granularity == ROLLUP_YEAR) {
+        date.tm_mday = 1;
+    }
+    if (granularity == ROLLUP_YEAR) {
+        date.tm_mon = 0;
+    }
+    return (static_cast<int64_t>(timegm(&date)) - UNIX_SECONDS_AT_2000) * MICROS_PER_SECOND;
+}
+
+static void checkBuckets(std::mt19937_64 &random) {
+    const std::vector<rollup_granularity> granularities = {ROLLUP_HOUR, ROLLUP_DAY, ROLLUP_WEEK, ROLLUP_MONTH,
+                                                           ROLLUP_YEAR};
+    // 1800 to 2200, before and after the epoch and across leap centuries.
+    const int64_t span = 200LL * 365 * 86400 * MICROS_PER_SECOND;
+    for (int trial = 0; trial < 20000; trial++) {
+        const int64_t timestamp = static_cast<int64_t>(random() % (2 * span)) - span;
+        for (rollup_granularity granularity: granularities) {
+            const int64_t start = rollupBucketStart(timestamp, granularity);
+            CHECK(start == referenceBucketStart(timestamp, granularity));
+            CHECK(start <= timestamp);
+            // A bucket starts in itself, the microsecond before it in the previous bucket.
+            CHECK(rollupBucketStart(start, granularity) == start);
+            CHECK(rollupBucketStart(start - 1, granularity) < start);
+        }
+    }
+    // 2000-01-01 was a Saturday: its week started on Monday 1999-12-27.
+    CHECK(rollupBucketStart(0, ROLLUP_WEEK) == -5LL * 86400 * MICROS_PER_SECOND);
+    CHECK(rollupBucketStart(-1, ROLLUP_YEAR) == -365LL * 86400 * MICROS_PER_SECOND);
+}
+
+static void checkGranularities() {
+    const std::vector<rollup_granularity> parsed = parseRollupGranularities(" Hour,day , WEEK,month,year");
+    CHECK(parsed == std::vector<rollup_granularity>({ROLLUP_HOUR, ROLLUP_DAY, ROLLUP_WEEK, ROLLUP_MONTH,
+                                                      ROLLUP_YEAR}));
+    for (rollup_granularity granularity: parsed) {
+        CHECK(parseRollupGranularities(rollupGranularityName(granularity))
+              == std::vector<rollup_granularity>({granularity}));
+    }
+    for (const char *invalid: {"", "day,", "dya", "day,day", "day;week"}) {
+        CHECK_THROWS(std::invalid_argument, parseRollupGranularities(invalid));
+    }
+}
+
+int main() {
+    std::mt19937_64 random(5);
+    checkBuckets(random);
+    checkGranularities();
+    return testResult();
+}
@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include "datasketches/theta/theta_serde.hpp"
+#include "test_common.hpp"
+#include "theta_test_sketch.hpp"
+
+/**
+ * Round trips through the compact and compressed formats of theta_serde.hpp.
+ */
+
+static const uint16_t SEED_HASH = computeSeedHash(9001);
+
+static std::vector<uint64_t> readCompact(const std::vector<char> &bytes) {
+    const uint8_t preambleLongs = bytes[0];
+    const uint32_t numEntries = preambleLongs > 1 ? theta_serde::readAt<uint32_t>(bytes.data() + 8)
+                                                  : static_cast<uint32_t>((bytes.size() - 8) / 8);
+    std::vector<uint64_t> hashes;
+    for (uint32_t i = 0; i < numEntries; i++) {
+        hashes.push_back(theta_serde::readAt<uint64_t>(bytes.data() + preambleLongs * 8 + i * 8));
+    }
+    return hashes;
+}
+
+static void checkCompressedRoundTrip(const theta_test_sketch &sketch) {
+    std::vector<char> bytes(compressedThetaSerializedSize(sketch));
+    CHECK(serializeCompressedTheta(sketch, bytes.data()) == bytes.size());
+    if (!isSuitableForCompression(sketch)) {
+        CHECK(!theta_serde::isCompressed(bytes.data(), bytes.size()));
+        CHECK(bytes == sketch.serializeCompact());
+        return;
+    }
+    CHECK(theta_serde::isCompressed(bytes.data(), bytes.size()));
+    CHECK(bytes.size() <= compactThetaSerializedSize(sketch));
+
+    const theta_serde::CompressedPreamble preamble = theta_serde::readCompressedPreamble(bytes.data(), bytes.size());
+    CHECK(preamble.seedHash == SEED_HASH);
+    CHECK(preamble.theta == sketch.theta);
+    CHECK(preamble.numEntries == sketch.hashes.size());
+    std::vector<uint64_t> hashes(preamble.numEntries);
+    theta_serde::unpackCompressedEntries(bytes.data(), preamble, hashes.data());
+    CHECK(hashes == sketch.hashes);
+
+    // Every truncation is detected rather than read past the end.
+    for (size_t length = 0; length < bytes.size(); length++) {
+        CHECK_THROWS(std::exception, theta_serde::readCompressedPreamble(bytes.data(), length));
+    }
+}
+
+int main() {
+    std::mt19937_64 random(7);
+    for (int trial = 0; trial < 500; trial++) {
+        const uint64_t theta = trial % 2 == 0 ? theta_serde::MAX_THETA : random() >> (1 + random() % 20);
+        // From dense hashes, too close to be compressed, to spread ones of up to 63 bits.
+        const uint64_t range = trial % 5 == 0 ? 1000000 : theta;
+        const size_t numHashes = trial % 7 == 0 ? random() % 3 : random() % 5000;
+        std::set<uint64_t> hashes;
+        while (hashes.size() < numHashes) {
+            hashes.insert(1 + random() % (range - 1));
+        }
+        const theta_test_sketch sketch(hashes, theta, false, SEED_HASH);
+        checkCompressedRoundTrip(sketch);
+
+        // Compact format: unordered sketches are written sorted.
+        const theta_test_sketch unordered(hashes, theta, false, SEED_HASH, false);
+        const std::vector<char> compact = unordered.serializeCompact();
+        CHECK(compact.size() == compactThetaSerializedSize(unordered));
+        CHECK(readCompact(compact) == sketch.hashes);
+        CHECK(compact == sketch.serializeCompact());
+    }
+
+    // Empty sketches are never compressed.
+    checkCompressedRoundTrip(theta_test_sketch({}, theta_serde::MAX_THETA, true, SEED_HASH));
+    CHECK(theta_test_sketch({}, theta_serde::MAX_THETA, true, SEED_HASH).serializeCompact().size() == 8);
+    return testResult();
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "datasketches/theta/theta_expression.hpp"
+#include "datasketches/theta/theta_serde.hpp"
+#include "datasketches/theta/theta_set_ops.hpp"
+#include "test_common.hpp"
+
+/**
+ * Sorted array set operations and set expressions against the same operations on std::set, with the semantics of
+ * theta_union, theta_intersection and theta_a_not_b.
+ */
+
+struct reference_sketch {
+    std::set<uint64_t> hashes;
+    uint64_t theta;
+    bool empty;
+
+    std::set<uint64_t> below(uint64_t newTheta) const {
+        return std::set<uint64_t>(hashes.begin(), hashes.lower_bound(newTheta));
+    }
+
+    theta_hashes toHashes() const {
+        theta_hashes result;
+        result.theta = theta;
+        result.empty = empty;
+        result.entries.assign(hashes.begin(), hashes.end());
+        return result;
+    }
+};
+
+static reference_sketch referenceUnion(const reference_sketch &a, const reference_sketch &b, uint32_t k) {
+    reference_sketch out{a.below(std::min(a.theta, b.theta)), std::min(a.theta, b.theta), a.empty && b.empty};
+    for (uint64_t hash: b.below(out.theta)) {
+        out.hashes.insert(hash);
+    }
+    if (k > 0 && out.hashes.size() > k) {
+        auto kth = std::next(out.hashes.begin(), k);
+        out.theta = *kth;
+        out.hashes.erase(kth, out.hashes.end());
+    }
+    return out;
+}
+
+static reference_sketch referenceIntersection(const reference_sketch &a, const reference_sketch &b) {
+    reference_sketch out{{}, std::min(a.theta, b.theta), true};
+    if (a.empty || b.empty) {
+        return out;
+    }
+    const std::set<uint64_t> hashesA = a.below(out.theta);
+    const std::set<uint64_t> hashesB = b.below(out.theta);
+    std::set_intersection(hashesA.begin(), hashesA.end(), hashesB.begin(), hashesB.end(),
+                          std::inserter(out.hashes, out.hashes.end()));
+    out.empty = out.hashes.empty() && out.theta == theta_serde::MAX_THETA;
+    return out;
+}
+
+static reference_sketch referenceANotB(const reference_sketch &a, const reference_sketch &b) {
+    if (a.empty || a.hashes.empty() || b.empty) {
+        return a;
+    }
+    reference_sketch out{{}, std::min(a.theta, b.theta), false};
+    const std::set<uint64_t> hashesA = a.below(out.theta);
+    const std::set<uint64_t> hashesB = b.below(out.theta);
+    std::set_difference(hashesA.begin(), hashesA.end(), hashesB.begin(), hashesB.end(),
+                        std::inserter(out.hashes, out.hashes.end()));
+    out.empty = out.hashes.empty() && out.theta == theta_serde::MAX_THETA;
+    return out;
+}
+
+static bool same(const theta_hashes &actual, const reference_sketch &expected) {
+    return actual.theta == expected.theta && actual.empty == expected.empty
+           && std::vector<uint64_t>(actual.entries.begin(), actual.entries.end())
+              == std::vector<uint64_t>(expected.hashes.begin(), expected.hashes.end());
+}
+
+static reference_sketch randomSketch(std::mt19937_64 &random) {
+    reference_sketch sketch{{}, theta_serde::MAX_THETA, false};
+    switch (random() % 6) {
+        case 0:
+            sketch.empty = true;
+            return sketch;
+        case 1:
+            // Not empty, yet without hashes below theta.
+            sketch.theta = 1 + random() % 50;
+            return sketch;
+        case 2:
+            sketch.theta = 1 + random() % 200;
+            break;
+        default:
+            break;
+    }
+    // Hashes from a small range, for overlapping sketches.
+    const size_t numHashes = random() % 60;
+    for (size_t i = 0; i < numHashes; i++) {
+        const uint64_t hash = 1 + random() % 250;
+        if (hash < sketch.theta) {
+            sketch.hashes.insert(hash);
+        }
+    }
+    return sketch;
+}
+
+static void checkSetOperations(std::mt19937_64 &random) {
+    for (int trial = 0; trial < 5000; trial++) {
+        const reference_sketch a = randomSketch(random);
+        const reference_sketch b = randomSketch(random);
+        const theta_hashes hashesA = a.toHashes();
+        const theta_hashes hashesB = b.toHashes();
+        const uint32_t k = trial % 3 == 0 ? 0 : 1 + random() % 40;
+        theta_hashes out;
+        thetaUnion(theta_hashes_view(hashesA), theta_hashes_view(hashesB), k, out);
+        CHECK(same(out, referenceUnion(a, b, k)));
+        thetaIntersection(theta_hashes_view(hashesA), theta_hashes_view(hashesB), out);
+        CHECK(same(out, referenceIntersection(a, b)));
+        thetaANotB(theta_hashes_view(hashesA), theta_hashes_view(hashesB), out);
+        CHECK(same(out, referenceANotB(a, b)));
+    }
+
+    // An exact intersection of disjoint sets is the empty set.
+    const theta_hashes a = reference_sketch{{1, 2}, theta_serde::MAX_THETA, false}.toHashes();
+    const theta_hashes b = reference_sketch{{3, 4}, theta_serde::MAX_THETA, false}.toHashes();
+    theta_hashes out;
+    thetaIntersection(theta_hashes_view(a), theta_hashes_view(b), out);
+    CHECK(out.empty && out.entries.empty());
+}
+
+/**
+ * Random expression over the first numInputs variables, fully parenthesized, and its reference result.
+ */
+static std::string randomExpression(std::mt19937_64 &random, const std::vector<reference_sketch> &inputs, int depth,
+                                    uint32_t k, reference_sketch &result) {
+    if (depth == 0 || random() % 4 == 0) {
+        const size_t input = random() % inputs.size();
+        result = inputs[input];
+        return std::string(1, static_cast<char>('a' + input));
+    }
+    reference_sketch left, right;
+    const std::string leftText = randomExpression(random, inputs, depth - 1, k, left);
+    const std::string rightText = randomExpression(random, inputs, depth - 1, k, right);
+    switch (random() % 3) {
+        case 0:
+            result = referenceUnion(left, right, k);
+            return "(" + leftText + " | " + rightText + ")";
+        case 1:
+            result = referenceIntersection(left, right);
+            return "(" + leftText + "&" + rightText + ")";
+        default:
+            result = referenceANotB(left, right);
+            return "(" + leftText + "-" + rightText + ")";
+    }
+}
+
+static void checkExpressions(std::mt19937_64 &random) {
+    for (int trial = 0; trial < 2000; trial++) {
+        std::vector<reference_sketch> inputs;
+        const size_t numInputs = 1 + random() % 6;
+        for (size_t i = 0; i < numInputs; i++) {
+            inputs.push_back(randomSketch(random));
+        }
+        std::vector<theta_hashes> hashes;
+        for (const reference_sketch &input: inputs) {
+            hashes.push_back(input.toHashes());
+        }
+        std::vector<theta_hashes_view> views(hashes.begin(), hashes.end());
+        const uint32_t k = trial % 2 == 0 ? 0 : 1 + random() % 40;
+        reference_sketch expected;
+        theta_expression expression(randomExpression(random, inputs, 4, k, expected));
+        CHECK(expression.getNumInputs() <= numInputs);
+        CHECK(same(expression.evaluate(views, k), expected));
+        // Buffers are reused from one evaluation to the next.
+        CHECK(same(expression.evaluate(views, k), expected));
+    }
+}
+
+static void checkPrecedence(std::mt19937_64 &random) {
+    const char *equivalents[][2] = {
+            {"a|b&c",        "a|(b&c)"},
+            {"a&b|c",        "(a&b)|c"},
+            {"a-b-c",        "(a-b)-c"},
+            {"a-b|c",        "(a-b)|c"},
+            {"a|b-c",        "(a|b)-c"},
+            {"(a|b)&c-d",    "((a|b)&c)-d"},
+            {" A | B & c ",  "a|(b&c)"},
+            {"((a))",        "a"},
+    };
+    for (int trial = 0; trial < 200; trial++) {
+        std::vector<theta_hashes> hashes;
+        for (int i = 0; i < 4; i++) {
+            hashes.push_back(randomSketch(random).toHashes());
+        }
+        std::vector<theta_hashes_view> views(hashes.begin(), hashes.end());
+        for (const auto &pair: equivalents) {
+            theta_expression expression(pair[0]);
+            theta_expression expected(pair[1]);
+            const theta_hashes &actual = expression.evaluate(views, 0);
+            const theta_hashes &reference = expected.evaluate(views, 0);
+            CHECK(actual.theta == reference.theta && actual.empty == reference.empty
+                  && actual.entries == reference.entries);
+        }
+    }
+
+    for (const char *invalid: {"", "a|", "(a", "a)", "a b", "a|1", "a&&b", "|a", "()"}) {
+        CHECK_THROWS(std::invalid_argument, theta_expression expression(invalid));
+    }
+    theta_expression expression("a|c");
+    CHECK(expression.getNumInputs() == 3);
+    std::vector<theta_hashes> hashes(2);
+    CHECK_THROWS(std::invalid_argument,
+                 expression.evaluate(std::vector<theta_hashes_view>(hashes.begin(), hashes.end()), 0));
+}
+
+int main() {
+    std::mt19937_64 random(1);
+    checkSetOperations(random);
+    checkExpressions(random);
+    checkPrecedence(random);
+    return testResult();
+}
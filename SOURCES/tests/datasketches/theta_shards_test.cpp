@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "datasketches/theta/theta_serde.hpp"
+#include "datasketches/theta/theta_shards.hpp"
+#include "test_common.hpp"
+
+/**
+ * Hash range shards: sharded set operations give the results of the plain ones, and shards concatenate back into
+ * their sketch, or into the union of sketches when each shard was unioned on its own.
+ */
+
+static theta_hashes randomHashes(std::mt19937_64 &random, size_t numHashes, uint64_t theta, uint64_t range) {
+    theta_hashes hashes;
+    hashes.theta = theta;
+    hashes.empty = false;
+    for (size_t i = 0; i < numHashes; i++) {
+        const uint64_t hash = 1 + (random() >> 1) % range;
+        if (hash < theta) {
+            hashes.entries.push_back(hash);
+        }
+    }
+    std::sort(hashes.entries.begin(), hashes.entries.end());
+    hashes.entries.erase(std::unique(hashes.entries.begin(), hashes.entries.end()), hashes.entries.end());
+    return hashes;
+}
+
+static bool same(const theta_hashes &a, const theta_hashes &b) {
+    return a.theta == b.theta && a.empty == b.empty && a.entries == b.entries;
+}
+
+static void checkShardedOperations(std::mt19937_64 &random) {
+    const uint64_t maxTheta = theta_serde::MAX_THETA;
+    for (int trial = 0; trial < 40; trial++) {
+        // Large enough to be split, except every fourth trial.
+        const size_t numHashes = trial % 4 == 0 ? 1000 : 40000 + random() % 100000;
+        // Hashes from a narrow range fill a few shards only.
+        const uint64_t range = trial % 3 == 0 ? maxTheta / 1000 : maxTheta;
+        const theta_hashes a = randomHashes(random, numHashes, trial % 2 == 0 ? maxTheta : maxTheta / 3, range);
+        theta_hashes b = randomHashes(random, numHashes / 2, trial % 5 == 0 ? maxTheta : maxTheta / 2, range);
+        // Overlap.
+        for (size_t i = 0; i < a.entries.size(); i += 3) {
+            if (a.entries[i] < b.theta) {
+                b.entries.push_back(a.entries[i]);
+            }
+        }
+        std::sort(b.entries.begin(), b.entries.end());
+        b.entries.erase(std::unique(b.entries.begin(), b.entries.end()), b.entries.end());
+        if (trial % 7 == 0) {
+            b.entries.clear();
+            b.empty = true;
+        } else if (trial % 6 == 1) {
+            // Disjoint.
+            decltype(b.entries) onlyB;
+            std::set_difference(b.entries.begin(), b.entries.end(), a.entries.begin(), a.entries.end(),
+                                std::back_inserter(onlyB));
+            b.entries.swap(onlyB);
+        }
+
+        const theta_hashes_view viewA(a);
+        const theta_hashes_view viewB(b);
+        const uint32_t k = trial % 2 == 0 ? 0 : 4096U << (trial % 5);
+        theta_hashes expected, actual;
+        for (unsigned numThreads: {1, 2, 5, 8}) {
+            thetaUnion(viewA, viewB, k, expected);
+            thetaShardedUnion(viewA, viewB, k, actual, numThreads);
+            CHECK(same(actual, expected));
+            thetaIntersection(viewA, viewB, expected);
+            thetaShardedIntersection(viewA, viewB, actual, numThreads);
+            CHECK(same(actual, expected));
+            thetaANotB(viewA, viewB, expected);
+            thetaShardedANotB(viewA, viewB, actual, numThreads);
+            CHECK(same(actual, expected));
+        }
+
+        // Stored shards unioned one by one, then concatenated and cut to k, give the union of the whole.
+        if (k > 0) {
+            const uint8_t lgShards = 1 + trial % 5;
+            std::vector<theta_hashes> shardUnions(1U << lgShards);
+            for (uint32_t shard = 0; shard < shardUnions.size(); shard++) {
+                thetaUnion(thetaShard(viewA, shard, lgShards), thetaShard(viewB, shard, lgShards), k,
+                           shardUnions[shard]);
+            }
+            std::vector<theta_hashes_view> views(shardUnions.begin(), shardUnions.end());
+            theta_hashes concatenated, none, cut;
+            thetaConcatenate(views, concatenated);
+            thetaUnion(theta_hashes_view(concatenated), theta_hashes_view(none), k, cut);
+            thetaUnion(viewA, viewB, k, expected);
+            CHECK(same(cut, expected));
+        }
+    }
+}
+
+static void checkRoundTrips(std::mt19937_64 &random) {
+    for (int trial = 0; trial < 50; trial++) {
+        const uint64_t theta = trial % 2 == 0 ? theta_serde::MAX_THETA : random() >> 1;
+        theta_hashes hashes = randomHashes(random, random() % 20000, theta, theta_serde::MAX_THETA);
+        hashes.empty = trial % 10 == 0 && hashes.entries.empty();
+        const theta_hashes_view view(hashes);
+        for (uint8_t lgShards: {0, 1, 4, 16}) {
+            std::vector<theta_hashes_view> shards;
+            size_t numHashes = 0;
+            for (uint32_t shard = 0; shard < (1U << lgShards); shard++) {
+                shards.push_back(thetaShard(view, shard, lgShards));
+                const theta_hashes_view &last = shards.back();
+                CHECK(last.theta == hashes.theta && last.empty == hashes.empty);
+                bool inShard = true;
+                for (const uint64_t *hash = last.begin; hash < last.end; hash++) {
+                    inShard = inShard && thetaShardOf(*hash, lgShards) == shard;
+                }
+                CHECK(inShard);
+                numHashes += last.end - last.begin;
+            }
+            CHECK(numHashes == hashes.entries.size());
+            theta_hashes concatenated;
+            thetaConcatenate(shards, concatenated);
+            CHECK(same(concatenated, hashes));
+            // Shards in any order.
+            std::reverse(shards.begin(), shards.end());
+            thetaConcatenate(shards, concatenated);
+            CHECK(same(concatenated, hashes));
+        }
+    }
+}
+
+int main() {
+    std::mt19937_64 random(1);
+    checkShardedOperations(random);
+    checkRoundTrips(random);
+    return testResult();
+}
@@ -0,0 +1,69 @@
+#ifndef VERTICA_UDFS_THETA_TEST_SKETCH_HPP
+#define VERTICA_UDFS_THETA_TEST_SKETCH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "datasketches/theta/theta_serde.hpp"
+
+/**
+ * Theta sketch with the interface theta_serde.hpp serializes from, built from a set of hashes: the expected result
+ * of an operation, or an input, without going through datasketches.
+ */
+struct theta_test_sketch {
+    std::vector<uint64_t> hashes;
+    uint64_t theta;
+    bool empty;
+    bool ordered;
+    uint16_t seedHash;
+
+    theta_test_sketch(const std::set<uint64_t> &hashes, uint64_t theta, bool empty, uint16_t seedHash,
+                      bool ordered = true)
+            : theta(theta), empty(empty), ordered(ordered), seedHash(seedHash) {
+        for (uint64_t hash: hashes) {
+            if (hash < theta) {
+                this->hashes.push_back(hash);
+            }
+        }
+        if (!ordered) {
+            std::reverse(this->hashes.begin(), this->hashes.end());
+        }
+    }
+
+    bool is_empty() const {
+        return empty;
+    }
+
+    bool is_ordered() const {
+        return ordered;
+    }
+
+    uint64_t get_theta64() const {
+        return theta;
+    }
+
+    uint32_t get_num_retained() const {
+        return static_cast<uint32_t>(hashes.size());
+    }
+
+    uint16_t get_seed_hash() const {
+        return seedHash;
+    }
+
+    std::vector<uint64_t>::const_iterator begin() const {
+        return hashes.begin();
+    }
+
+    std::vector<uint64_t>::const_iterator end() const {
+        return hashes.end();
+    }
+
+    std::vector<char> serializeCompact() const {
+        std::vector<char> bytes(compactThetaSerializedSize(*this));
+        bytes.resize(serializeCompactTheta(*this, bytes.data()));
+        return bytes;
+    }
+};
+
+#endif //VERTICA_UDFS_THETA_TEST_SKETCH_HPP